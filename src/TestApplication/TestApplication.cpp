@@ -33,21 +33,42 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
     using std::unique_ptr;
     using std::make_unique;
     using ItSoftware::Linux::ItsString;
+    using ItSoftware::Linux::ItsRegexCache;
     using ItSoftware::Linux::ItsExpandDirection;
     using ItSoftware::Linux::ItsTime;
     using ItSoftware::Linux::ItsConvert;
+    using ItSoftware::Linux::ItsHex;
+    using ItSoftware::Linux::ItsClock;
+    using ItSoftware::Linux::ItsEpochTime;
     using ItSoftware::Linux::ItsRandom;
+    using ItSoftware::Linux::ItsRandomFill;
+    using ItSoftware::Linux::ItsXoshiro256StarStar;
+    using ItSoftware::Linux::ItsXoshiro256StarStarX8;
+    using ItSoftware::Linux::ItsPcg32;
+    using ItSoftware::Linux::ItsChaCha20Random;
     using ItSoftware::Linux::ItsDateTime;
     using ItSoftware::Linux::ItsLog;
     using ItSoftware::Linux::ItsLogType;
+    using ItSoftware::Linux::ItsLogOverflowPolicy;
+    using ItSoftware::Linux::ItsLogItem;
+    using ItSoftware::Linux::ItsPattern;
+    using ItSoftware::Linux::ItsBinaryLogReader;
     using ItSoftware::Linux::ItsDataSizeStringType;
     using ItSoftware::Linux::ItsID;
     using ItSoftware::Linux::ItsCreateIDOptions;
     using ItSoftware::Linux::Core::ItsTimer;
+    using ItSoftware::Linux::Core::ItsTscTimer;
+    using ItSoftware::Linux::Core::ItsTscClock;
+    using ItSoftware::Linux::Core::ItsProfiler;
+    using ItSoftware::Linux::Core::ItsTrace;
+    using ItSoftware::Linux::Core::ItsTimeTrackerMode;
+    using ItSoftware::Linux::Core::ItsPerfCounters;
     using ItSoftware::Linux::Core::ItsFile;
     using ItSoftware::Linux::Core::ItsGuid;
     using ItSoftware::Linux::Core::ItsGuidFormat;
+    using ItSoftware::Linux::Core::ItsGuidValue;
     using ItSoftware::Linux::Core::ItsPath;
+    using ItSoftware::Linux::Core::ItsPathCache;
     using ItSoftware::Linux::Core::ItsDirectory;
     using ItSoftware::Linux::Core::ItsError;
     using ItSoftware::Linux::Core::ItsFileMonitor;
@@ -86,6 +107,7 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
     void TestItsID();
     void TestItsGuid();
     void TestItsPath();
+    void TestItsPathCache();
     void TestItsDirectory();
     void TestItsFileMonitorStart();
     void TestItsFileMonitorStop();
@@ -118,6 +140,8 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
     char g_filename[] = "/tmp/CppIncludeLinux/test.txt";
     char g_copyToFilename[] = "/tmp/CppIncludeLinux/test2.txt";
     char g_shredFilename[] = "/tmp/CppIncludeLinux/test2shred.txt";
+    char g_binaryLogFilename[] = "/tmp/CppIncludeLinux/test.blog";
+    char g_logFilename[] = "/tmp/CppIncludeLinux/test.log";
     string g_path1("/tmp");
     string g_path2("/CppIncludeLinux/test.txt");
     string g_invalidPath("home\0/kjetilso");
@@ -191,6 +215,7 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
         TestItsID();
         TestItsGuid();
         TestItsPath();
+        TestItsPathCache();
         TestItsDirectory();
         TestItsFileMonitorStop();
         TestItsSocketDatagramClientServerStop();
@@ -312,6 +337,20 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
         cout << R"(ItsConvert::ToNumber<unsigned short>("40001"))" << endl;
         cout << "> " << ItsConvert::ToNumber<unsigned short>("40001") << endl;
 
+        PrintSubHeader("TryParse / Format");
+        int parsed = 0;
+        cout << R"(ItsConvert::TryParse("-1234", &parsed))" << endl;
+        cout << "> " << (ItsConvert::TryParse("-1234", &parsed) ? "true " : "false ") << parsed << endl;
+        cout << R"(ItsConvert::TryParse("12x", &parsed))" << endl;
+        cout << "> " << (ItsConvert::TryParse("12x", &parsed) ? "true" : "false") << endl;
+        char number[ItsConvert::NumberBufferSize];
+        cout << R"(ItsConvert::Format(1.234, buffer, size))" << endl;
+        cout << R"(> ")" << string(number, ItsConvert::Format(1.234, number, sizeof(number))) << R"(")" << endl;
+        double row[3];
+        size_t rowCount = ItsConvert::ParseDelimited("1.5; 2.25 ;3", ';', row, 3);
+        cout << R"(ItsConvert::ParseDelimited("1.5; 2.25 ;3", ';', row, 3))" << endl;
+        cout << "> " << rowCount << ": " << row[0] << " " << row[1] << " " << row[2] << endl;
+
         PrintSubHeader("ToString");
         cout << R"(ItsConvert::ToString<int>(-1234))" << endl;
         cout << R"(> ")" << ItsConvert::ToString<int>(-1234) << R"(")" << endl;
@@ -357,6 +396,11 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
         cout << R"(> ")" << ItsConvert::ToDataSizeString(SIZE_MAX, 2) << R"(")" << endl;
         cout << R"(ItsConvert::ToDataSizeString(size_t max, 2, ItsDataSizeStringType::IEC))" << endl;
         cout << R"(> ")" << ItsConvert::ToDataSizeString(SIZE_MAX, 2, ItsDataSizeStringType::IEC) << R"(")" << endl;
+        size_t sizes[] = { 512, 1536, 200100400 };
+        char column[3 * 10];
+        size_t cells = ItsConvert::ToDataSizeStringColumn(sizes, 3, 2, ItsDataSizeStringType::Recommended, column, sizeof(column), 10);
+        cout << R"(ItsConvert::ToDataSizeStringColumn({ 512, 1536, 200100400 }, 3, 2, ItsDataSizeStringType::Recommended, column, sizeof(column), 10))" << endl;
+        cout << R"(> ")" << string(column, cells * 10) << R"(")" << endl;
 
         PrintSubHeader("ToLongFromHex");
         cout << R"(ItsConvert::ToLongFromHex("0xFF3333"))" << endl;
@@ -386,6 +430,28 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
         cout << "> " << ItsRandom<double>(1, 2) << endl;
         cout << "ItsRandom<double>(1, 2)" << endl;
         cout << "> " << ItsRandom<double>(1, 2) << endl;
+        cout << "ItsRandom<int, ItsPcg32>(1, 6)" << endl;
+        cout << "> " << ItsRandom<int, ItsPcg32>(1, 6) << endl;
+        cout << "ItsRandom<int, ItsChaCha20Random>(1, 6)" << endl;
+        cout << "> " << ItsRandom<int, ItsChaCha20Random>(1, 6) << endl;
+
+        ItsXoshiro256StarStar gen1(2024);
+        ItsXoshiro256StarStar gen2(2024);
+        cout << "ItsXoshiro256StarStar gen1(2024), gen2(2024): gen1() == gen2()" << endl;
+        cout << "> " << ((gen1() == gen2()) ? "true" : "false") << endl;
+        gen2.Jump();
+        cout << "gen2.Jump(): gen1() == gen2()" << endl;
+        cout << "> " << ((gen1() == gen2()) ? "true" : "false") << endl;
+
+        ItsXoshiro256StarStarX8 bulk(2024);
+        vector<double> values(1'000'000);
+        ItsRandomFill(bulk, values.data(), values.size(), 0.0, 1.0);
+        double sum = 0;
+        for (double v : values) {
+            sum += v;
+        }
+        cout << "ItsRandomFill(bulk, values.data(), 1'000'000, 0.0, 1.0), mean" << endl;
+        cout << "> " << sum / values.size() << endl;
 
         cout << endl;
     }
@@ -433,6 +499,8 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
         cout << R"(> ")" << ItsString::ToLowerCase("Ab12Cd") << R"(")" << endl;
         cout << R"(ItsString::ToUpperCase("Ab12Cd"))" << endl;
         cout << R"(> ")" << ItsString::ToUpperCase("Ab12Cd") << R"(")" << endl;
+        cout << R"(ItsString::EqualsIgnoreCase("Content-Length","content-length"))" << endl;
+        cout << R"(> )" << (ItsString::EqualsIgnoreCase("Content-Length", "content-length") ? "true" : "false") << endl;
         cout << R"(ItsString::Trim("  Ab12Cd  "))" << endl;
         cout << R"(> ")" << ItsString::Trim("  Ab12Cd  ") << R"(")" << endl;
         cout << R"(ItsString::Replace("__ ABCDEF __"))" << endl;
@@ -454,6 +522,46 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
         
         string temp = ss.str();
         cout << "> " << temp << endl;
+        cout << R"(ItsString::SplitView("A::BC::::G","::"))" << endl;
+        cout << "> {";
+        bFirst = true;
+        for (auto part : ItsString::SplitView("A::BC::::G", "::")) {
+            cout << (bFirst ? "" : ",") << R"(")" << part << R"(")";
+            bFirst = false;
+        }
+        cout << "}" << endl;
+        cout << R"(ItsString::WordsFromText("one, two_2;three"))" << endl;
+        cout << "> {";
+        bFirst = true;
+        for (auto word : ItsString::WordsFromText("one, two_2;three")) {
+            cout << (bFirst ? "" : ",") << R"(")" << word << R"(")";
+            bFirst = false;
+        }
+        cout << "}" << endl;
+        cout << R"(ItsRegexCache::GetPattern("status=5\d\d|timeout")->Search("id=7 status=503"))" << endl;
+        auto pattern = ItsRegexCache::GetPattern("status=5\\d\\d|timeout");
+        cout << "> " << (pattern->Search("id=7 status=503") ? "true" : "false") << endl;
+        cout << "ItsPattern(expression).Search(text) vs std::regex_search(text, std::regex(expression))" << endl;
+        struct PatternCase { const char* Expression; const char* Text; bool IgnoreCase; };
+        PatternCase patternCases[] = {
+            { "a{2}", "aa", false }, { "a{2}", "a{2}", false }, { "a{2,}b", "xaaab", false }, { "(ab){1,2}c", "ababc", false },
+            { "\\bfoo\\b", "foo bar", false }, { "a\\Bb", "ab", false }, { "[]a]", "a]", false }, { ".", "\r", false }, { "a+?", "", false },
+            { "[^a]", "A", true }, { "[^x-z]+$", "X", true }, { "[a-c]+", "ABC", true }
+        };
+        for (auto& c : patternCases) {
+            ItsPattern itsPattern(c.Expression, c.IgnoreCase);
+            cout << "> " << c.Expression << (c.IgnoreCase ? " (ignoreCase)" : "") << " on \"" << ItsString::Replace(c.Text, "\r", "\\r") << "\": ";
+            if (itsPattern.IsValid()) {
+                auto flags = c.IgnoreCase ? (std::regex::ECMAScript | std::regex::icase) : std::regex::ECMAScript;
+                bool same = itsPattern.Search(c.Text) == std::regex_search(c.Text, std::regex(c.Expression, flags));
+                cout << (itsPattern.Search(c.Text) ? "true" : "false") << (same ? " (same as std::regex)" : " (DIFFERS from std::regex)") << endl;
+            }
+            else {
+                cout << "invalid: " << itsPattern.GetError() << endl;
+            }
+        }
+        cout << R"(ItsString::TrimView("\t Ab12Cd \r\n"))" << endl;
+        cout << R"(> ")" << ItsString::TrimView("\t Ab12Cd \r\n") << R"(")" << endl;
         cout << R"(ItsString::WidthExpand ("Kjetil", 30, L'_', ItsExpandDirection:Left))" << endl;
         cout << R"(> ")" << ItsString::WidthExpand("Kjetil", 30, L'_', ItsExpandDirection::Left) << R"(")" << endl;
         cout << R"(ItsString::WidthExpand ("Kjetil", 30, L'_', ItsExpandDirection:Middle))" << endl;
@@ -485,6 +593,63 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
 
         PrintSubHeader("ToString(tailN=1)");
         cout << log.ToString(1) << endl;
+
+        ItsLog asyncLog{"ItsTestApp", false, 1024, ItsLogOverflowPolicy::Count};
+        asyncLog.LogInformation("This is an asynchronous information log item");
+        asyncLog.LogWarning("This is an asynchronous warning log item");
+
+        PrintSubHeader("Asynchronous ToString");
+        cout << asyncLog.ToString() << endl;
+
+        PrintSubHeader("SetMinimumLevel(Warning) + Log<Type>");
+        ItsLog levelLog{"ItsTestApp", false};
+        levelLog.SetMinimumLevel(ItsLogType::Warning);
+        levelLog.Log<ItsLogType::Debug>([]() { return string("This debug item is never constructed"); });
+        levelLog.Log<ItsLogType::Information>("This information item with {} is filtered", 1);
+        levelLog.Log<ItsLogType::Error>("This is an error log item with {} arguments: {}", 2, true);
+        cout << levelLog.ToString() << endl;
+
+        PrintSubHeader("SetRetention(2) + ToString");
+        log.SetRetention(2);
+        log.LogInformation("This is an information log item after SetRetention(2)");
+        cout << log.ToString() << endl;
+
+        PrintSubHeader("ForEachItem");
+        log.ForEachItem([](const ItsLogItem& item) { cout << item.ToString() << endl; });
+        cout << endl;
+
+        PrintSubHeader("OpenFileSink");
+        {
+            ItsLog fileLog{"ItsTestApp", false};
+            cout << R"(fileLog.OpenFileSink(g_logFilename, 1024 * 1024, 3600, true))" << endl;
+            if (fileLog.OpenFileSink(g_logFilename, 1024 * 1024, 3600, true)) {
+                fileLog.LogInformation("This is an information log item written to file");
+                fileLog.Flush();
+                cout << "> Success. " << ItsFile::GetFileSize(g_logFilename) << " bytes written to " << g_logFilename << endl;
+            }
+            else {
+                cout << "> FAILED: " << ItsError::GetLastErrorDescription() << endl;
+            }
+        }
+        ItsFile::Delete(g_logFilename);
+
+        PrintSubHeader("OpenBinaryLog + ItsBinaryLogReader");
+        {
+            ItsLog binaryLog{"ItsTestApp", false};
+            if (binaryLog.OpenBinaryLog(g_binaryLogFilename)) {
+                auto formatId = binaryLog.RegisterFormat("Request {} completed in {} us");
+                binaryLog.LogFormat(ItsLogType::Information, formatId, "/index.html", 125);
+                binaryLog.LogWarning("This is a binary warning log item");
+            }
+        }
+        ItsBinaryLogReader reader;
+        if (reader.Open(g_binaryLogFilename)) {
+            ItsLogItem item;
+            while (reader.Next(item)) {
+                cout << item.ToString() << endl;
+            }
+        }
+        ItsFile::Delete(g_binaryLogFilename);
         
         cout << endl;
     }
@@ -528,7 +693,12 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
             return;
         }
         cout << "> Success. Read all text from file " << g_filename << endl;
-                
+
+        cout << "file.GetLineReader()" << endl;
+        file.SetPosFromBeg(0);
+        for (auto line : file.GetLineReader()) {
+            cout << R"(> ")" << line << R"(")" << endl;
+        }
 
         cout << "file.Close()" << endl;
         file.Close();
@@ -625,6 +795,51 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
         g_timer.Stop();
         cout << "Elapsed Time: " << ItsTime::RenderMsToFullString(g_timer.GetMilliseconds(),true) << endl;
 
+        cout << "ItsTscClock::IsInvariant()" << endl;
+        cout << "> " << (ItsTscClock::IsInvariant() ? "true" : "false") << endl;
+        cout << "ItsTscClock::GetFrequency()" << endl;
+        cout << "> " << static_cast<int64_t>(ItsTscClock::GetFrequency() / 1'000'000) << " MHz" << endl;
+
+        ItsTscTimer tscTimer;
+        tscTimer.Start();
+        int64_t sum = 0;
+        for (int i = 0; i < 1000; i++) {
+            sum += ItsTscClock::now().time_since_epoch().count() & 1;
+        }
+        tscTimer.Stop();
+        cout << "ItsTscTimer, 1000 x ItsTscClock::now()" << endl;
+        cout << "> " << tscTimer.GetNanoseconds() << " ns" << endl;
+
+        for (int i = 0; i < 1000; i++) {
+            ITS_PROFILE_SCOPE("TestItsTimerStop loop");
+            sum += ItsRandom<int>(0, 1);
+        }
+        cout << "ITS_PROFILE_SCOPE(\"TestItsTimerStop loop\") x 1000, ItsProfiler::ToJson()" << endl;
+        cout << "> " << ItsProfiler::ToJson() << endl;
+
+        ItsTrace::Start();
+        {
+            DebugOnly<ItsTimeTracker> outer("TestItsTimerStop trace", ItsTimeTrackerMode::Trace);
+            for (int i = 0; i < 3; i++) {
+                ITS_TRACE_SCOPE("TestItsTimerStop inner");
+                sum += ItsRandom<int>(0, 1);
+            }
+        }
+        ItsTrace::Stop();
+        string traceFilename = g_directoryRoot + "trace.json";
+        cout << "ItsTrace::WriteChromeJson(traceFilename)" << endl;
+        cout << "> " << (ItsTrace::WriteChromeJson(traceFilename) ? "Success" : "FAILED") << ", " << ItsFile::GetFileSize(traceFilename) << " bytes" << endl;
+
+        ItsPerfCounters perf;
+        vector<int64_t> values;
+        perf.Start();
+        for (int i = 0; i < 100000; i++) {
+            values.push_back(sum + i);
+        }
+        perf.Stop();
+        cout << "ItsPerfCounters, 100000 x vector::push_back, GetSample(100000).ToString()" << endl;
+        cout << perf.GetSample(100000).ToString();
+
         cout << endl;
     }
 
@@ -654,6 +869,30 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
 
         cout << "Custom: " << now.ToString("dd.MM.yyyy HH:mm:ss") << endl;
 
+        int ms = 0;
+        ItsDateTime nowMs(ItsClock::NowMilliseconds(&ms));
+        cout << "ItsClock::NowMilliseconds: " << nowMs.ToString() << "." << std::setw(3) << std::setfill('0') << std::right << ms << endl;
+
+        char buffer[ItsConvert::DateTimeBufferSize];
+        size_t length = now.ToString("s", buffer, sizeof(buffer));
+        cout << "Buffer: " << string(buffer, length) << endl;
+
+        tm parsed{};
+        int offset = 0;
+        if (ItsConvert::TryParseDateTime("2024-02-29T13:45:10.250+02:00", &parsed, &offset)) {
+            cout << "TryParseDateTime(\"2024-02-29T13:45:10.250+02:00\"): " << ItsDateTime(parsed).ToString() << " offset " << offset << "s" << endl;
+        }
+
+        constexpr auto leap = ItsEpochTime::FromCivil(2024, 2, 29, 13, 45, 10);
+        static_assert(leap.GetDay() == 29 && leap.GetMonth() == 2 && leap.GetYear() == 2024, "civil round trip");
+        auto epoch = ItsEpochTime::Now();
+        cout << "ItsEpochTime::Now(): " << epoch.ToString() << " (" << epoch.Nanoseconds() << " ns)" << endl;
+        auto later = epoch;
+        later.AddDays(7).AddHours(1).AddMilliseconds(250);
+        cout << "AddDays(7).AddHours(1).AddMilliseconds(250): " << later.ToString() << " (+" << (later - epoch) << " ns)" << endl;
+        cout << "Truncate(NanosecondsPerHour): " << later.Truncate(ItsEpochTime::NanosecondsPerHour).ToString() << endl;
+        cout << "ToDateTime(): " << epoch.ToDateTime().ToString() << endl;
+
         cout << endl;
     }
 
@@ -683,6 +922,20 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
         cout << "ItsID::CreateID(64, ItsCreateIDOptions::LowerAndUpperCase, true)" << endl;
         cout << R"(> ")" << ItsID::CreateID(64, ItsCreateIDOptions::LowerAndUpperCase, true) << R"(")" << endl;
 
+        char id[33];
+        cout << "ItsID::CreateID(id, sizeof(id), 32, ItsCreateIDOptions::LowerAndUpperCase, true)" << endl;
+        size_t idLength = ItsID::CreateID(id, sizeof(id), 32, ItsCreateIDOptions::LowerAndUpperCase, true);
+        cout << R"(> ")" << id << R"(", length )" << idLength << endl;
+
+        cout << "ItsID::CreateSecureID(32, ItsCreateIDOptions::LowerAndUpperCase, true)" << endl;
+        cout << R"(> ")" << ItsID::CreateSecureID(32, ItsCreateIDOptions::LowerAndUpperCase, true) << R"(")" << endl;
+
+        string arena = ItsID::CreateIDs(3, 12, ItsCreateIDOptions::LowerCase, true);
+        cout << "ItsID::CreateIDs(3, 12, ItsCreateIDOptions::LowerCase, true)" << endl;
+        for (size_t i = 0; i < 3; i++) {
+            cout << R"(> ")" << ItsID::GetID(arena, 12, i) << R"(")" << endl;
+        }
+
         cout << endl;
     }
 
@@ -714,7 +967,28 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
             cout << R"(> ")" << ItsGuid::ToString(guid, ItsGuidFormat::MicrosoftCompactFormat, true) << R"(")" << endl;
             cout << "ItsGuid::ToString(guid,ItsGuidFormat::MicrosoftPrefixedCompactFormat, true)" << endl;
             cout << R"(> ")" << ItsGuid::ToString(guid, ItsGuidFormat::MicrosoftPrefixedCompactFormat, true) << R"(")" << endl;
+
+            uuid_t parsed{ 0 };
+            string registry = ItsGuid::ToString(guid);
+            cout << "ItsGuid::TryParse(registry, parsed)" << endl;
+            cout << "> " << ((ItsGuid::TryParse(registry, parsed) && ItsGuid::ToString(parsed) == registry) ? "Success" : "FAILED") << endl;
+            cout << "ItsHex::Encode(guid, sizeof(guid))" << endl;
+            cout << R"(> ")" << ItsHex::Encode(guid, sizeof(guid)) << R"(")" << endl;
+        }
+
+        cout << "ItsGuid::CreateGuidValue()" << endl;
+        ItsGuidValue v4 = ItsGuid::CreateGuidValue();
+        cout << R"(> ")" << v4.ToString() << R"(", version )" << v4.GetVersion() << endl;
+        cout << "ItsGuid::ToString(ItsGuid::CreateGuidValue(7))" << endl;
+        cout << R"(> ")" << ItsGuid::ToString(ItsGuid::CreateGuidValue(7)) << R"(")" << endl;
+
+        vector<ItsGuidValue> values = ItsGuid::CreateGuidValues(100000, 7);
+        bool ordered = true;
+        for (size_t i = 1; i < values.size(); i++) {
+            ordered = ordered && values[i - 1] < values[i];
         }
+        cout << "ItsGuid::CreateGuidValues(100000, 7)" << endl;
+        cout << "> " << values.size() << " values, " << (ordered ? "strictly increasing" : "NOT ORDERED") << endl;
 
         cout << endl;
     }
@@ -755,6 +1029,49 @@ namespace ItSoftware::CppIncludeLinux::TestApplication
         cout << R"(> )" << ((ItsPath::IsPathValid(g_invalidPath)) ? "true" : "false") << endl;
         cout << R"(ItsPath::GetParentDirectory("path"))" << endl;
         cout << R"(> )" << ItsPath::GetParentDirectory(path) << endl;
+        cout << R"(ItsPath::GetFilenameView(path))" << endl;
+        cout << R"(> ")" << ItsPath::GetFilenameView(path) << R"(")" << endl;
+        cout << R"(ItsPath::GetParentDirectoryView(path))" << endl;
+        cout << R"(> ")" << ItsPath::GetParentDirectoryView(path) << R"(")" << endl;
+
+        char buffer[64];
+        size_t length{0};
+        cout << R"(ItsPath::Combine(g_path1, g_path2, buffer, &length))" << endl;
+        if (ItsPath::Combine(g_path1, g_path2, buffer, &length)) {
+            cout << R"(> ")" << buffer << R"(", length: )" << length << endl;
+        }
+        else {
+            cout << "> Buffer too small" << endl;
+        }
+
+        cout << endl;
+    }
+
+    //
+    // Function: TestItsPathCache
+    //
+    // (i): Test ItsPathCache
+    //
+    void TestItsPathCache()
+    {
+        PrintHeader("ItsPathCache");
+
+        ItsPathCache cache;
+        cout << R"(ItsPathCache::Normalize("/tmp/./a//b/../c/"))" << endl;
+        cout << R"(> ")" << ItsPathCache::Normalize("/tmp/./a//b/../c/") << R"(")" << endl;
+
+        auto id1 = cache.Intern("/tmp/CppIncludeLinux/test.txt");
+        auto id2 = cache.Intern("/tmp/CppIncludeLinux/x/../test.txt");
+        cout << R"(cache.Intern("/tmp/CppIncludeLinux/test.txt") == cache.Intern("/tmp/CppIncludeLinux/x/../test.txt"))" << endl;
+        cout << R"(> )" << ((id1 == id2) ? "true" : "false") << endl;
+        cout << R"(cache.GetPath(cache.GetParent(id1)))" << endl;
+        cout << R"(> ")" << cache.GetPath(cache.GetParent(id1)) << R"(")" << endl;
+        cout << R"(cache.IsAncestorOf(cache.Intern("/tmp"), id1))" << endl;
+        cout << R"(> )" << ((cache.IsAncestorOf(cache.Intern("/tmp"), id1)) ? "true" : "false") << endl;
+        cout << R"(cache.GetPath(cache.Resolve(cache.Intern(g_directoryRoot))))" << endl;
+        cout << R"(> ")" << cache.GetPath(cache.Resolve(cache.Intern(g_directoryRoot))) << R"(")" << endl;
+        cout << R"(cache.Count())" << endl;
+        cout << R"(> )" << cache.Count() << endl;
 
         cout << endl;
     }
@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////
+//: Title        : ItsLogDecoder.cpp
+//: Product:     : Cpp.Include.Linux
+//: Date         : 2026-10-19
+//: Author       : "Kjetil Kristoffer Solberg" <post@ikjetil.no>
+//: Version      : 1.0.0.0
+//: Descriptions : Decodes binary ItsLog files to text.
+//
+// #include
+//
+#include <iostream>
+#include <string>
+#include "../include/itsoftware-linux.h"
+
+namespace ItSoftware::CppIncludeLinux::ItsLogDecoder
+{
+    //
+    // using
+    //
+    using std::cout;
+    using std::cerr;
+    using std::endl;
+    using std::string;
+    using ItSoftware::Linux::ItsBinaryLogReader;
+    using ItSoftware::Linux::ItsLogItem;
+
+    //
+    // Function: main
+    //
+    // (i): Prints every record of the given files in ItsLogItem::ToString format.
+    //
+    int main(int argc, const char* argv[])
+    {
+        if (argc < 2)
+        {
+            cerr << "Usage: " << argv[0] << " <binary-log-file> [<binary-log-file> ...]" << endl;
+            return EXIT_FAILURE;
+        }
+
+        for (int i = 1; i < argc; i++)
+        {
+            ItsBinaryLogReader reader;
+            if (!reader.Open(argv[i]))
+            {
+                cerr << argv[i] << ": not a binary ItsLog file" << endl;
+                return EXIT_FAILURE;
+            }
+
+            ItsLogItem item;
+            while (reader.Next(item))
+            {
+                cout << item.ToString() << '\n';
+            }
+        }
+
+        return EXIT_SUCCESS;
+    }
+}
+
+//
+// Function: main
+//
+// (i): Application entry point.
+//      Redirects to ItSoftware::CppIncludeLinux::ItsLogDecoder::main.
+//
+int main(int argc, const char* argv[])
+{
+    return ItSoftware::CppIncludeLinux::ItsLogDecoder::main(argc, argv);
+}
@@ -0,0 +1,15 @@
+#!/bin/bash
+#: Title       : build.sh
+#: Date        : 2026-10-19
+#: Author      : Kjetil Kristoffer Solberg <post@ikjetil.no>
+#: Version     : 1.0
+#: Description : Builds the Cpp.Include.Linux tools.
+echo "Building ItsLogDecoder..."
+g++ -O2 ItsLogDecoder.cpp -std=c++17 -pthread -o ItsLogDecoder
+if [[ $? -eq 0 ]]
+then
+    echo "> ItsLogDecoder build ok <"
+else
+    echo "> ItsLogDecoder build error <"
+fi
+echo "> build process complete <"
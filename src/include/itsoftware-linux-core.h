@@ -19,6 +19,11 @@
 #include <iostream>
 #include <vector>
 #include <chrono>
+#include <string_view>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <cmath>
 
 #include <fcntl.h>
 #include <dlfcn.h>
@@ -29,8 +34,19 @@
 #include <sys/types.h>
 #include <dirent.h>
 #include <uuid/uuid.h>
+#include <sys/random.h>
+#include <endian.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#include <pthread.h>
 #include <sys/inotify.h>
+#include <limits.h>
 #include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
 
 #include "itsoftware-linux.h"
 
@@ -53,6 +69,10 @@ namespace ItSoftware::Linux::Core
     using std::end;
     using std::any_of;
     using ItSoftware::Linux::ItsString;
+    using ItSoftware::Linux::ItsLineReader;
+    using ItSoftware::Linux::ItsHex;
+    using ItSoftware::Linux::ItsXoshiro256StarStar;
+    using ItSoftware::Linux::ItsForkGeneration;
     
     //
     // #define
@@ -60,55 +80,626 @@ namespace ItSoftware::Linux::Core
     #define FILE_MONITOR_BUFFER_LENGTH (10 * (sizeof(inotify_event) + NAME_MAX + 1))
 
     //
-    // class: ItsTimeTracker
+    // struct: ItsTscClock
     //
-    // (i): Simple time tracking class that prints elapsed time on destruction.
+    // (i): std::chrono clock on the CPU time stamp counter (rdtscp, a few ns per read
+    //      against ~20 ns for steady_clock::now()). Calibrated against steady_clock on
+    //      first use; used only when the CPU reports an invariant TSC, otherwise (and
+    //      off x86) now() is steady_clock::now(). Readings are not comparable across
+    //      machines or with steady_clock time points.
     //
-    class ItsTimeTracker {
+    struct ItsTscClock
+    {
+        using rep = int64_t;
+        using period = std::nano;
+        using duration = std::chrono::nanoseconds;
+        using time_point = std::chrono::time_point<ItsTscClock>;
+        static constexpr bool is_steady = true;
+
+    private:
+        //
+        // (i): now() = BaseNs + (Ticks() - BaseTicks) * NsPerTick32. Calibrate moves the
+        //      base to the current reading before changing the rate, so time stays
+        //      continuous. The three values are published under a sequence lock.
+        //
+        struct Calibration
+        {
+            bool Enabled = false;
+            std::atomic<uint32_t> Sequence{ 0 };
+            std::atomic<uint64_t> BaseTicks{ 0 };
+            std::atomic<int64_t> BaseNs{ 0 };
+            std::atomic<uint64_t> NsPerTick32{ 0 };  // ns per tick, 32.32 fixed point
+            std::mutex Writer;
+
+            Calibration()
+            {
+                this->Enabled = ItsTscClock::IsInvariant();
+                if (this->Enabled) {
+                    uint64_t ticks = 0;
+                    int64_t ns = 0;
+                    uint64_t nsPerTick32 = ItsTscClock::Measure(std::chrono::milliseconds(5), &ticks, &ns);
+                    this->Publish(ticks, ns, nsPerTick32);
+                }
+            }
+
+            void Publish(uint64_t baseTicks, int64_t baseNs, uint64_t nsPerTick32)
+            {
+                uint32_t sequence = this->Sequence.load(std::memory_order_relaxed);
+                this->Sequence.store(sequence + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                this->BaseTicks.store(baseTicks, std::memory_order_relaxed);
+                this->BaseNs.store(baseNs, std::memory_order_relaxed);
+                this->NsPerTick32.store(nsPerTick32, std::memory_order_relaxed);
+                this->Sequence.store(sequence + 2, std::memory_order_release);
+            }
+
+            void Read(uint64_t& baseTicks, int64_t& baseNs, uint64_t& nsPerTick32) const
+            {
+                for (;;) {
+                    uint32_t sequence = this->Sequence.load(std::memory_order_acquire);
+                    baseTicks = this->BaseTicks.load(std::memory_order_relaxed);
+                    baseNs = this->BaseNs.load(std::memory_order_relaxed);
+                    nsPerTick32 = this->NsPerTick32.load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if ((sequence & 1) == 0 && this->Sequence.load(std::memory_order_relaxed) == sequence) {
+                        return;
+                    }
+                }
+            }
+        };
+        static Calibration& GetCalibration()
+        {
+            static Calibration calibration;
+            return calibration;
+        }
+        // (i): Rate in 32.32 ns per tick over span, 0 on failure. ticks and ns receive the end point.
+        static uint64_t Measure(std::chrono::nanoseconds span, uint64_t* ticks, int64_t* ns)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            uint64_t c0 = ItsTscClock::Ticks();
+            auto t1 = t0;
+            while (t1 - t0 < span) {
+                t1 = std::chrono::steady_clock::now();
+            }
+            uint64_t c1 = ItsTscClock::Ticks();
+            *ticks = c1;
+            *ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1.time_since_epoch()).count();
+            uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            return (c1 > c0) ? static_cast<uint64_t>((static_cast<__uint128_t>(elapsed) << 32) / (c1 - c0)) : 0;
+        }
+        static int64_t ToNanoseconds(uint64_t ticks, uint64_t baseTicks, int64_t baseNs, uint64_t nsPerTick32)
+        {
+            __int128 delta = static_cast<__int128>(static_cast<int64_t>(ticks - baseTicks)) * static_cast<__int128>(nsPerTick32);
+            return baseNs + static_cast<int64_t>(delta >> 32);
+        }
+    public:
+        //
+        // Function: IsInvariant
+        //
+        // (i): True if the CPU reports an invariant TSC (constant rate in all P/C states).
+        //
+        static bool IsInvariant()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+                return false;
+            }
+            if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0) {
+                return false;
+            }
+            return (edx & (1u << 8)) != 0;
+#else
+            return false;
+#endif
+        }
+
+        // True if now() reads the TSC.
+        static bool IsEnabled()
+        {
+            return ItsTscClock::GetCalibration().Enabled;
+        }
+
+        // Raw time stamp counter, 0 off x86.
+        static uint64_t Ticks() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            unsigned int aux;
+            return __rdtscp(&aux);
+#else
+            return 0;
+#endif
+        }
+
+        // Tick count (a difference of Ticks()) in nanoseconds at the current rate.
+        static int64_t ToNanoseconds(uint64_t ticks)
+        {
+            uint64_t nsPerTick32 = ItsTscClock::GetCalibration().NsPerTick32.load(std::memory_order_relaxed);
+            return static_cast<int64_t>((static_cast<__uint128_t>(ticks) * nsPerTick32) >> 32);
+        }
+
+        // Ticks per second, 0 when disabled.
+        static double GetFrequency()
+        {
+            uint64_t nsPerTick32 = ItsTscClock::GetCalibration().NsPerTick32.load(std::memory_order_relaxed);
+            return (nsPerTick32 == 0) ? 0.0 : 1e9 * 4294967296.0 / static_cast<double>(nsPerTick32);
+        }
+
+        //
+        // Function: Calibrate
+        //
+        // (i): Re-measures the tick rate over span (startup uses 5 ms), for better accuracy.
+        //      now() continues from its current value at the new rate, so it never
+        //      jumps and open intervals stay valid.
+        //
+        static void Calibrate(std::chrono::nanoseconds span)
+        {
+            Calibration& calibration = ItsTscClock::GetCalibration();
+            if (!calibration.Enabled) {
+                return;
+            }
+            uint64_t ticks = 0;
+            int64_t ns = 0;
+            uint64_t nsPerTick32 = ItsTscClock::Measure(span, &ticks, &ns);
+            if (nsPerTick32 == 0) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(calibration.Writer);
+            uint64_t baseTicks = 0;
+            int64_t baseNs = 0;
+            uint64_t oldNsPerTick32 = 0;
+            calibration.Read(baseTicks, baseNs, oldNsPerTick32);
+            uint64_t now = ItsTscClock::Ticks();
+            calibration.Publish(now, ItsTscClock::ToNanoseconds(now, baseTicks, baseNs, oldNsPerTick32), nsPerTick32);
+        }
+
+        static time_point now() noexcept
+        {
+            Calibration& calibration = ItsTscClock::GetCalibration();
+            if (!calibration.Enabled) {
+                return time_point(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()));
+            }
+            uint64_t baseTicks = 0;
+            int64_t baseNs = 0;
+            uint64_t nsPerTick32 = 0;
+            calibration.Read(baseTicks, baseNs, nsPerTick32);
+            return time_point(duration(ItsTscClock::ToNanoseconds(ItsTscClock::Ticks(), baseTicks, baseNs, nsPerTick32)));
+        }
+    };
+
+    //
+    // struct: ItsTraceEvent
+    //
+    // (i): One completed scope: name (static lifetime), start and duration in
+    //      ItsTscClock nanoseconds, and nesting depth on its thread.
+    //
+    struct ItsTraceEvent
+    {
+        const char* Name;
+        int64_t Start;
+        int64_t Duration;
+        uint32_t Depth;
+    };
+
+    //
+    // class: ItsTraceBuffer
+    //
+    // (i): Per thread event buffer: chunks of ChunkSize events, appended by the owning
+    //      thread only and published with a release store of the count, so ItsTrace can
+    //      read while the thread records. Events past MaxEvents are dropped and counted.
+    //
+    class ItsTraceBuffer
+    {
+    public:
+        static constexpr size_t ChunkSize = 4096;
+        static constexpr size_t MaxChunks = 256;
+        static constexpr size_t MaxEvents = ChunkSize * MaxChunks;
+
+    private:
+        std::atomic<ItsTraceEvent*> m_chunks[MaxChunks];
+        std::atomic<size_t> m_count{ 0 };
+        std::atomic<uint64_t> m_dropped{ 0 };
+        std::atomic<uint32_t> m_generation{ 0 };
+        std::atomic<bool> m_exited{ false };
+        pid_t m_tid;
+        string m_threadName;
+
+    public:
+        ItsTraceBuffer(pid_t tid, const string& threadName, uint32_t generation)
+            : m_tid(tid), m_threadName(threadName)
+        {
+            for (auto& chunk : this->m_chunks) {
+                chunk.store(nullptr, std::memory_order_relaxed);
+            }
+            this->m_generation.store(generation, std::memory_order_relaxed);
+        }
+
+        ~ItsTraceBuffer()
+        {
+            for (auto& chunk : this->m_chunks) {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+
+        ItsTraceBuffer(const ItsTraceBuffer&) = delete;
+        ItsTraceBuffer& operator=(const ItsTraceBuffer&) = delete;
+
+        //
+        // Method: Append
+        //
+        // (i): Owning thread only. A buffer from an earlier ItsTrace::Start generation
+        //      starts over, keeping its chunks.
+        //
+        void Append(const ItsTraceEvent& event, uint32_t generation)
+        {
+            size_t count = this->m_count.load(std::memory_order_relaxed);
+            if (this->m_generation.load(std::memory_order_relaxed) != generation) {
+                count = 0;
+                this->m_dropped.store(0, std::memory_order_relaxed);
+                this->m_count.store(0, std::memory_order_relaxed);
+                this->m_generation.store(generation, std::memory_order_release);
+            }
+            if (count >= MaxEvents) {
+                this->m_dropped.store(this->m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return;
+            }
+            ItsTraceEvent* chunk = this->m_chunks[count / ChunkSize].load(std::memory_order_relaxed);
+            if (chunk == nullptr) {
+                chunk = new ItsTraceEvent[ChunkSize];
+                this->m_chunks[count / ChunkSize].store(chunk, std::memory_order_release);
+            }
+            chunk[count % ChunkSize] = event;
+            this->m_count.store(count + 1, std::memory_order_release);
+        }
+
+        // Events recorded in generation, fn(const ItsTraceEvent&) for each.
+        template <typename Fn>
+        void ForEach(uint32_t generation, Fn fn) const
+        {
+            if (this->m_generation.load(std::memory_order_acquire) != generation) {
+                return;
+            }
+            size_t count = this->m_count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; i++) {
+                fn(this->m_chunks[i / ChunkSize].load(std::memory_order_acquire)[i % ChunkSize]);
+            }
+        }
+
+        uint64_t GetDropped() const { return this->m_dropped.load(std::memory_order_relaxed); }
+        pid_t GetThreadId() const { return this->m_tid; }
+        const string& GetThreadName() const { return this->m_threadName; }
+        bool IsExited() const { return this->m_exited.load(std::memory_order_relaxed); }
+        void SetExited() { this->m_exited.store(true, std::memory_order_relaxed); }
+    };
+
+    //
+    // struct: ItsTrace
+    //
+    // (i): Timeline tracing of scopes across threads, exported as Chrome trace event
+    //      JSON (chrome://tracing, ui.perfetto.dev). Off until Start(); while off a
+    //      scope costs one relaxed load. Record with ITS_TRACE_SCOPE("name"),
+    //      ItsTraceScope, or an ItsTimeTracker in ItsTimeTrackerMode::Trace (wrap either
+    //      in DebugOnly to compile it out of release builds). Names must outlive export.
+    //
+    struct ItsTrace
+    {
+    private:
+        struct Registry
+        {
+            std::mutex Mutex;
+            vector<std::shared_ptr<ItsTraceBuffer>> Buffers;
+            std::atomic<bool> Enabled{ false };
+            std::atomic<uint32_t> Generation{ 1 };
+        };
+        struct ThreadState
+        {
+            std::shared_ptr<ItsTraceBuffer> Buffer;
+            uint32_t Depth = 0;
+
+            ~ThreadState()
+            {
+                if (this->Buffer != nullptr) {
+                    this->Buffer->SetExited();
+                }
+            }
+        };
+        static Registry& GetRegistry()
+        {
+            // (i): Never destroyed, threads may record while the process exits.
+            static Registry* registry = new Registry();
+            return *registry;
+        }
+        static ThreadState& GetThreadState()
+        {
+            static thread_local ThreadState state;
+            return state;
+        }
+        static ItsTraceBuffer& GetBuffer(ThreadState& state)
+        {
+            if (state.Buffer == nullptr) {
+                char name[32]{ 0 };
+                pthread_getname_np(pthread_self(), name, sizeof(name));
+                Registry& registry = ItsTrace::GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.Mutex);
+                state.Buffer = std::make_shared<ItsTraceBuffer>(static_cast<pid_t>(syscall(SYS_gettid)), string(name),
+                    registry.Generation.load(std::memory_order_relaxed));
+                registry.Buffers.push_back(state.Buffer);
+            }
+            return *state.Buffer;
+        }
+    public:
+        //
+        // Function: Start
+        //
+        // (i): Discards earlier events and starts recording. Do not call while exporting.
+        //
+        static void Start()
+        {
+            Registry& registry = ItsTrace::GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.Mutex);
+            registry.Generation.fetch_add(1, std::memory_order_relaxed);
+            registry.Buffers.erase(std::remove_if(registry.Buffers.begin(), registry.Buffers.end(),
+                [](const std::shared_ptr<ItsTraceBuffer>& b) { return b->IsExited(); }), registry.Buffers.end());
+            registry.Enabled.store(true, std::memory_order_release);
+        }
+
+        static void Stop()
+        {
+            ItsTrace::GetRegistry().Enabled.store(false, std::memory_order_release);
+        }
+
+        static bool IsEnabled()
+        {
+            return ItsTrace::GetRegistry().Enabled.load(std::memory_order_relaxed);
+        }
+
+        static int64_t Now()
+        {
+            return ItsTscClock::now().time_since_epoch().count();
+        }
+
+        // Opens a scope on the calling thread, returns its start time.
+        static int64_t Enter()
+        {
+            ItsTrace::GetThreadState().Depth++;
+            return ItsTrace::Now();
+        }
+
+        // Closes the scope opened by Enter, recording it as name.
+        static void Leave(const char* name, int64_t start)
+        {
+            int64_t end = ItsTrace::Now();
+            ThreadState& state = ItsTrace::GetThreadState();
+            state.Depth--;
+            ItsTraceEvent event{ name, start, end - start, state.Depth };
+            ItsTrace::GetBuffer(state).Append(event, ItsTrace::GetRegistry().Generation.load(std::memory_order_relaxed));
+        }
+
+        //
+        // Function: ToChromeJson
+        //
+        // (i): Events since Start() in Chrome trace event format: one complete ("X")
+        //      event per scope with depth in args, plus thread_name metadata.
+        //
+        static string ToChromeJson()
+        {
+            Registry& registry = ItsTrace::GetRegistry();
+            vector<std::shared_ptr<ItsTraceBuffer>> buffers;
+            uint32_t generation;
+            {
+                std::lock_guard<std::mutex> lock(registry.Mutex);
+                buffers = registry.Buffers;
+                generation = registry.Generation.load(std::memory_order_relaxed);
+            }
+
+            string pid = std::to_string(getpid());
+            string json("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+            bool first = true;
+            char number[ItsConvert::NumberBufferSize];
+            auto appendMicroseconds = [&json, &number](int64_t ns) {
+                // (i): Microseconds with three decimals, Chrome's ts/dur unit.
+                int64_t us = ns / 1000;
+                int64_t fraction = ns % 1000;
+                if (ns < 0 && fraction != 0) {
+                    us -= 1;
+                    fraction += 1000;
+                }
+                size_t n = ItsConvert::Format(us, number, sizeof(number));
+                json.append(number, n);
+                json += '.';
+                json += static_cast<char>('0' + fraction / 100);
+                json += static_cast<char>('0' + fraction / 10 % 10);
+                json += static_cast<char>('0' + fraction % 10);
+            };
+
+            for (auto& buffer : buffers) {
+                string tid = std::to_string(buffer->GetThreadId());
+                json += first ? "\n" : ",\n";
+                first = false;
+                json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":\"";
+                ItsString::AppendJsonEscaped(json, buffer->GetThreadName());
+                json += "\"}}";
+                buffer->ForEach(generation, [&](const ItsTraceEvent& e) {
+                    json += ",\n{\"name\":\"";
+                    ItsString::AppendJsonEscaped(json, (e.Name != nullptr) ? e.Name : "");
+                    json += "\",\"cat\":\"its\",\"ph\":\"X\",\"ts\":";
+                    appendMicroseconds(e.Start);
+                    json += ",\"dur\":";
+                    appendMicroseconds(e.Duration);
+                    json += ",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"depth\":" + std::to_string(e.Depth) + "}}";
+                });
+            }
+            json += "\n]}\n";
+            return json;
+        }
+
+        //
+        // Function: WriteChromeJson
+        //
+        // (i): Writes ToChromeJson() to filename. Returns false on I/O error.
+        //
+        static bool WriteChromeJson(const string& filename)
+        {
+            string json = ItsTrace::ToChromeJson();
+            FILE* file = fopen(filename.c_str(), "w");
+            if (file == nullptr) {
+                return false;
+            }
+            bool ok = fwrite(json.data(), 1, json.size(), file) == json.size();
+            return (fclose(file) == 0) && ok;
+        }
+
+        // Events dropped because a thread's buffer was full, since Start().
+        static uint64_t GetDropped()
+        {
+            Registry& registry = ItsTrace::GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.Mutex);
+            uint64_t dropped = 0;
+            for (auto& buffer : registry.Buffers) {
+                dropped += buffer->GetDropped();
+            }
+            return dropped;
+        }
+    };
+
+    //
+    // class: ItsTraceScope
+    //
+    // (i): Records the enclosing scope as an ItsTrace event when tracing is on.
+    //
+    class ItsTraceScope
+    {
+    private:
+        const char* m_name;
+        int64_t m_start = 0;
+        bool m_active;
+    public:
+        explicit ItsTraceScope(const char* name)
+            : m_name(name), m_active(ItsTrace::IsEnabled())
+        {
+            if (this->m_active) {
+                this->m_start = ItsTrace::Enter();
+            }
+        }
+
+        ~ItsTraceScope()
+        {
+            if (this->m_active) {
+                ItsTrace::Leave(this->m_name, this->m_start);
+            }
+        }
+
+        ItsTraceScope(const ItsTraceScope&) = delete;
+        ItsTraceScope& operator=(const ItsTraceScope&) = delete;
+    };
+
+    //
+    // ITS_TRACE_SCOPE
+    //
+    // (i): Traces the rest of the enclosing scope as name. Define ITS_NO_TRACE to
+    //      compile it out.
+    //
+    #define ITS_CONCAT2(a, b) a##b
+    #define ITS_CONCAT(a, b) ITS_CONCAT2(a, b)
+    #ifndef ITS_NO_TRACE
+    #define ITS_TRACE_SCOPE(name) ItSoftware::Linux::Core::ItsTraceScope ITS_CONCAT(its_trace_scope_, __LINE__)(name)
+    #else
+    #define ITS_TRACE_SCOPE(name) do {} while (0)
+    #endif
+
+    //
+    // enum: ItsTimeTrackerMode
+    //
+    // (i): Print (or callback) the elapsed time, or record it as an ItsTrace event.
+    //
+    enum class ItsTimeTrackerMode
+    {
+        Print,
+        Trace
+    };
+
+    //
+    // class: ItsBasicTimeTracker
+    //
+    // (i): Simple time tracking class that prints elapsed time on destruction, or
+    //      passes it to a callback. Clock is steady_clock (ItsTimeTracker) or
+    //      ItsTscClock (ItsTscTimeTracker).
+    //
+    template <typename Clock = std::chrono::steady_clock>
+    class ItsBasicTimeTracker {
     private:	
-        std::chrono::time_point<std::chrono::steady_clock> start, end;
+        typename Clock::time_point start, end;
         std::string  name;
         std::wstring wname;
         bool wide{ false };
         bool callback{ false };
-        std::function<void(const std::string& name, std::chrono::steady_clock::duration)> fnComplete = nullptr;
-        std::function<void(const std::wstring& name, std::chrono::steady_clock::duration)> wfnComplete = nullptr;
+        std::function<void(const std::string& name, typename Clock::duration)> fnComplete = nullptr;
+        std::function<void(const std::wstring& name, typename Clock::duration)> wfnComplete = nullptr;
+        const char* traceName{ nullptr };
+        int64_t traceStart{ 0 };
+        bool trace{ false };
+        bool traceActive{ false };
     public:
-        explicit ItsTimeTracker(const std::string& fName)
+        explicit ItsBasicTimeTracker(const std::string& fName)
             : name(fName),
             wide(false),
-            start(std::chrono::steady_clock::now())
+            start(Clock::now())
         {
         }
 
-        explicit ItsTimeTracker(const std::wstring& fName)
+        explicit ItsBasicTimeTracker(const std::wstring& fName)
             : wname(fName),
             wide(true),
-            start(std::chrono::steady_clock::now())
+            start(Clock::now())
         {
         }
 
-        ItsTimeTracker(const std::string& fName, std::function<void(std::string name, std::chrono::steady_clock::duration)> ff)
+        ItsBasicTimeTracker(const std::string& fName, std::function<void(std::string name, typename Clock::duration)> ff)
             : name(fName),
             fnComplete(ff),
             wide(false),
-            start(std::chrono::steady_clock::now()),
+            start(Clock::now()),
             callback(true)
         {
         }
 
-        ItsTimeTracker(const std::wstring& fName, std::function<void(std::wstring name, std::chrono::steady_clock::duration)> ff)
+        ItsBasicTimeTracker(const std::wstring& fName, std::function<void(std::wstring name, typename Clock::duration)> ff)
             : wname(fName),
             wfnComplete(ff),
             wide(true),
-            start(std::chrono::steady_clock::now()),
+            start(Clock::now()),
             callback(true)
         {
         }
 
-        ~ItsTimeTracker() noexcept
+        //
+        // (i): ItsTimeTrackerMode::Trace records an ItsTrace event named fName (which must
+        //      outlive the export) when tracing is on, and never prints or allocates.
+        //      ItsTimeTrackerMode::Print is ItsBasicTimeTracker(std::string(fName)).
+        //
+        ItsBasicTimeTracker(const char* fName, ItsTimeTrackerMode mode)
+            : start(mode == ItsTimeTrackerMode::Trace ? typename Clock::time_point() : Clock::now()),
+            name(mode == ItsTimeTrackerMode::Print ? fName : ""),
+            traceName(fName),
+            trace(mode == ItsTimeTrackerMode::Trace),
+            traceActive(mode == ItsTimeTrackerMode::Trace && ItsTrace::IsEnabled())
+        {
+            if (this->traceActive) {
+                this->traceStart = ItsTrace::Enter();
+            }
+        }
+
+        ~ItsBasicTimeTracker() noexcept
         {
-            end = std::chrono::steady_clock::now();
+            if (trace) {
+                if (traceActive) {
+                    ItsTrace::Leave(traceName, traceStart);
+                }
+                return;
+            }
+
+            end = Clock::now();
 
             if (callback) {
                 if (wide) {
@@ -136,20 +727,26 @@ namespace ItSoftware::Linux::Core
         }
 
         // No copying or moving
-        ItsTimeTracker(const ItsTimeTracker&) = delete;
-        ItsTimeTracker& operator=(const ItsTimeTracker&) = delete;
-        ItsTimeTracker(ItsTimeTracker&&) = delete;
-        ItsTimeTracker& operator=(ItsTimeTracker&&) = delete;
+        ItsBasicTimeTracker(const ItsBasicTimeTracker&) = delete;
+        ItsBasicTimeTracker& operator=(const ItsBasicTimeTracker&) = delete;
+        ItsBasicTimeTracker(ItsBasicTimeTracker&&) = delete;
+        ItsBasicTimeTracker& operator=(ItsBasicTimeTracker&&) = delete;
     };
+
+    using ItsTimeTracker = ItsBasicTimeTracker<std::chrono::steady_clock>;
+    using ItsTscTimeTracker = ItsBasicTimeTracker<ItsTscClock>;
     
     //
-    // struct: ItsTimer
+    // struct: ItsBasicTimer
+    //
+    // (i): Start/stop timer on Clock, steady_clock (ItsTimer) or ItsTscClock (ItsTscTimer).
     //
-    struct ItsTimer
+    template <typename Clock = std::chrono::steady_clock>
+    struct ItsBasicTimer
     {
         private:
-        std::chrono::time_point<std::chrono::steady_clock> m_start;
-        std::chrono::time_point<std::chrono::steady_clock> m_end;        
+        typename Clock::time_point m_start;
+        typename Clock::time_point m_end;        
         bool m_isRunning = false;
 
         public:
@@ -157,7 +754,7 @@ namespace ItSoftware::Linux::Core
         {
             if (!this->IsRunning())
             {
-                this->m_start = std::chrono::steady_clock::now();
+                this->m_start = Clock::now();
                 this->m_end = m_start;
                 this->m_isRunning = true;
             }
@@ -165,7 +762,7 @@ namespace ItSoftware::Linux::Core
 
         void Stop()
         {
-            this->m_end = std::chrono::steady_clock::now();
+            this->m_end = Clock::now();
             this->m_isRunning = false;
         }
 
@@ -181,7 +778,7 @@ namespace ItSoftware::Linux::Core
                 return 0;
             }
 
-            return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - this->m_start).count();
+            return std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - this->m_start).count();
         }
 
         int64_t LapMilliseconds()
@@ -191,7 +788,7 @@ namespace ItSoftware::Linux::Core
                 return 0;
             }
 
-            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - this->m_start).count();
+            return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - this->m_start).count();
         }
 
         int64_t LapMicroseconds()
@@ -201,7 +798,7 @@ namespace ItSoftware::Linux::Core
                 return 0;
             }
 
-            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - this->m_start).count();
+            return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - this->m_start).count();
         }
 
         int64_t LapNanoseconds()
@@ -210,7 +807,7 @@ namespace ItSoftware::Linux::Core
             {
                 return 0;
             }
-            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->m_start).count();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - this->m_start).count();
         }
 
         int64_t GetSeconds()
@@ -253,56 +850,1268 @@ namespace ItSoftware::Linux::Core
         }
     };
 
+    using ItsTimer = ItsBasicTimer<std::chrono::steady_clock>;
+    using ItsTscTimer = ItsBasicTimer<ItsTscClock>;
+
     //
-    // struct: ItsGuidFormat
+    // enum: ItsPerfCounter
     //
-    // (i): Container for premade Guid format strings.
+    // (i): Counters of an ItsPerfCounters group; hardware first, then software.
     //
-    struct ItsGuidFormat {
-        inline static constexpr const char* MicrosoftRegistryFormat{"{%08lX-%04X-%04x-%02X%02X-%02X%02X%02X%02X%02X%02X}"};
-        inline static constexpr const char* MicrosoftRegistryFormatStripped{ "%08lX-%04X-%04x-%02X%02X-%02X%02X%02X%02X%02X%02X" };
-        inline static constexpr const char* MicrosoftConstFormat{ "{ 0x%lx, 0x%x, 0x%x, { 0x%x, 0x%x, 0x%x, 0x%x, 0x%x, 0x%x, 0x%x, 0x%x } }" };
-        inline static constexpr const char* MicrosoftCompactFormat{ "%08lX%04X%04x%02X%02X%02X%02X%02X%02X%02X%02X" };
-        inline static constexpr const char* MicrosoftPrefixedCompactFormat{ "GUID%08lX%04X%04x%02X%02X%02X%02X%02X%02X%02X%02X" };
+    enum class ItsPerfCounter
+    {
+        Cycles,
+        Instructions,
+        CacheReferences,
+        CacheMisses,
+        Branches,
+        BranchMisses,
+        PageFaults,
+        ContextSwitches,
+        Count
     };
 
     //
-    // struct: ItsGuid
+    // struct: ItsPerfSample
     //
-    // (i): Wrapper for Guid generation and rendering.
+    // (i): Counter values and wall time of one Start/Stop section, scaled when the
+    //      kernel multiplexed the group. Unsupported counters are not Valid.
     //
-    struct ItsGuid
+    struct ItsPerfSample
     {
-    public:
-        static string CreateGuid()
+        static constexpr size_t CounterCount = static_cast<size_t>(ItsPerfCounter::Count);
+
+        uint64_t Values[CounterCount]{ 0 };
+        bool Valid[CounterCount]{ false };
+        int64_t Nanoseconds = 0;
+        uint64_t Iterations = 1;
+        int Error = 0;  // errno of the first counter that could not be opened, or why none were counted
+
+        static const char* GetName(ItsPerfCounter counter)
         {
-            uuid_t guid{0};
-            uuid_generate(guid);
-            return ItsGuid::ToString(guid);
+            static constexpr const char* names[CounterCount]{ "cycles", "instructions", "cache-references",
+                "cache-misses", "branches", "branch-misses", "page-faults", "context-switches" };
+            return names[static_cast<size_t>(counter)];
         }
-        static bool CreateGuid(uuid_t pGuid)
+
+        bool IsValid(ItsPerfCounter counter) const
         {
-            uuid_generate_random(pGuid);
-            return true;
+            return this->Valid[static_cast<size_t>(counter)];
         }
-        static string ToString(uuid_t guid) {
-            return ItsGuid::ToString(guid, ItsGuidFormat::MicrosoftRegistryFormat, true);
+
+        uint64_t Get(ItsPerfCounter counter) const
+        {
+            return this->Values[static_cast<size_t>(counter)];
+        }
+
+        // Value divided by Iterations, 0 when not Valid.
+        double GetPerIteration(ItsPerfCounter counter) const
+        {
+            if (!this->IsValid(counter) || this->Iterations == 0) {
+                return 0.0;
+            }
+            return static_cast<double>(this->Get(counter)) / static_cast<double>(this->Iterations);
+        }
+
+        // Instructions per cycle, 0 when not available.
+        double GetIpc() const
+        {
+            return this->GetRatio(ItsPerfCounter::Instructions, ItsPerfCounter::Cycles);
+        }
+
+        // Cache misses per cache reference.
+        double GetCacheMissRate() const
+        {
+            return this->GetRatio(ItsPerfCounter::CacheMisses, ItsPerfCounter::CacheReferences);
+        }
+
+        // Branch misses per branch.
+        double GetBranchMissRate() const
+        {
+            return this->GetRatio(ItsPerfCounter::BranchMisses, ItsPerfCounter::Branches);
+        }
+
+        double GetRatio(ItsPerfCounter numerator, ItsPerfCounter denominator) const
+        {
+            if (!this->IsValid(numerator) || !this->IsValid(denominator) || this->Get(denominator) == 0) {
+                return 0.0;
+            }
+            return static_cast<double>(this->Get(numerator)) / static_cast<double>(this->Get(denominator));
+        }
+
+        //
+        // Method: ToString
+        //
+        // (i): One line per valid counter with its per iteration value, then time, IPC
+        //      and miss rates when available.
+        //
+        string ToString() const
+        {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(2);
+            for (size_t i = 0; i < CounterCount; i++) {
+                auto counter = static_cast<ItsPerfCounter>(i);
+                if (this->IsValid(counter)) {
+                    ss << std::left << std::setw(18) << GetName(counter) << std::right << std::setw(16) << this->Get(counter)
+                       << std::setw(16) << std::setprecision(4) << this->GetPerIteration(counter) << " /iter\n";
+                }
+            }
+            ss << std::left << std::setw(18) << "time (ns)" << std::right << std::setw(16) << this->Nanoseconds
+               << std::setw(16) << std::setprecision(2) << static_cast<double>(this->Nanoseconds) / static_cast<double>(std::max<uint64_t>(1, this->Iterations)) << " /iter\n";
+            if (this->IsValid(ItsPerfCounter::Instructions) && this->IsValid(ItsPerfCounter::Cycles)) {
+                ss << "IPC " << this->GetIpc();
+                if (this->IsValid(ItsPerfCounter::CacheMisses) && this->IsValid(ItsPerfCounter::CacheReferences)) {
+                    ss << ", cache miss rate " << this->GetCacheMissRate() * 100.0 << "%";
+                }
+                if (this->IsValid(ItsPerfCounter::BranchMisses) && this->IsValid(ItsPerfCounter::Branches)) {
+                    ss << ", branch miss rate " << this->GetBranchMissRate() * 100.0 << "%";
+                }
+                ss << '\n';
+            }
+            if (this->Error != 0) {
+                ss << "some counters unavailable: " << strerror(this->Error) << '\n';
+            }
+            return ss.str();
+        }
+    };
+
+    //
+    // class: ItsPerfCounters
+    //
+    // (i): Hardware (and a few software) counters for the calling thread via
+    //      perf_event_open, opened once as one group and read at Start/Stop together
+    //      with an ItsTimer. Hardware counters are user space only, so they work at
+    //      perf_event_paranoid 2. Software counters include the kernel, where faults
+    //      are handled and context switches happen; when that is refused page faults
+    //      are counted in user space only and context switches are taken from
+    //      getrusage(RUSAGE_THREAD). Counters the kernel or CPU refuses (no PMU in a
+    //      VM, paranoid 3, seccomp) are left out; with none at all only the time is
+    //      measured and GetError tells why. RAII: the destructor closes the counters.
+    //
+    class ItsPerfCounters
+    {
+    private:
+        static constexpr size_t CounterCount = ItsPerfSample::CounterCount;
+
+        int m_fds[CounterCount];
+        int m_leader = -1;
+        size_t m_opened = 0;
+        size_t m_order[CounterCount]{ 0 };  // group read position -> counter
+        int m_error = 0;
+        bool m_rusageSwitches = false;
+        uint64_t m_startSwitches = 0;
+        ItsTimer m_timer;
+        ItsPerfSample m_sample;
+
+        static bool GetConfig(ItsPerfCounter counter, __u32* type, __u64* config)
+        {
+            switch (counter)
+            {
+            case ItsPerfCounter::Cycles: *type = PERF_TYPE_HARDWARE; *config = PERF_COUNT_HW_CPU_CYCLES; return true;
+            case ItsPerfCounter::Instructions: *type = PERF_TYPE_HARDWARE; *config = PERF_COUNT_HW_INSTRUCTIONS; return true;
+            case ItsPerfCounter::CacheReferences: *type = PERF_TYPE_HARDWARE; *config = PERF_COUNT_HW_CACHE_REFERENCES; return true;
+            case ItsPerfCounter::CacheMisses: *type = PERF_TYPE_HARDWARE; *config = PERF_COUNT_HW_CACHE_MISSES; return true;
+            case ItsPerfCounter::Branches: *type = PERF_TYPE_HARDWARE; *config = PERF_COUNT_HW_BRANCH_INSTRUCTIONS; return true;
+            case ItsPerfCounter::BranchMisses: *type = PERF_TYPE_HARDWARE; *config = PERF_COUNT_HW_BRANCH_MISSES; return true;
+            case ItsPerfCounter::PageFaults: *type = PERF_TYPE_SOFTWARE; *config = PERF_COUNT_SW_PAGE_FAULTS; return true;
+            case ItsPerfCounter::ContextSwitches: *type = PERF_TYPE_SOFTWARE; *config = PERF_COUNT_SW_CONTEXT_SWITCHES; return true;
+            default: return false;
+            }
+        }
+
+        static int Open(ItsPerfCounter counter, int groupFd, bool excludeKernel)
+        {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            if (!ItsPerfCounters::GetConfig(counter, &attr.type, &attr.config)) {
+                errno = EINVAL;
+                return -1;
+            }
+            attr.disabled = (groupFd == -1) ? 1 : 0;
+            attr.exclude_kernel = excludeKernel ? 1 : 0;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+        }
+
+        static uint64_t GetThreadSwitches()
+        {
+            rusage usage{};
+            if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+                return 0;
+            }
+            return static_cast<uint64_t>(usage.ru_nvcsw) + static_cast<uint64_t>(usage.ru_nivcsw);
+        }
+
+        // (i): Returns 0 or the errno why the group has no values.
+        int Read(uint64_t* values)
+        {
+            // (i): nr, time_enabled, time_running, value[nr]
+            uint64_t buffer[3 + CounterCount]{ 0 };
+            ssize_t n = read(this->m_leader, buffer, sizeof(buffer));
+            if (n < static_cast<ssize_t>(sizeof(uint64_t) * (3 + this->m_opened))) {
+                return (n < 0) ? errno : EIO;
+            }
+            uint64_t enabled = buffer[1];
+            uint64_t running = buffer[2];
+            if (running == 0) {
+                // (i): Never scheduled on the PMU, e.g. all counters taken by other perf users.
+                return EBUSY;
+            }
+            for (size_t i = 0; i < this->m_opened && i < buffer[0]; i++) {
+                uint64_t v = buffer[3 + i];
+                if (running > 0 && running < enabled) {
+                    v = static_cast<uint64_t>(static_cast<double>(v) * static_cast<double>(enabled) / static_cast<double>(running));
+                }
+                values[this->m_order[i]] = v;
+            }
+            return 0;
+        }
+    public:
+        ItsPerfCounters()
+        {
+            for (size_t i = 0; i < CounterCount; i++) {
+                this->m_fds[i] = -1;
+            }
+            for (size_t i = 0; i < CounterCount; i++) {
+                auto counter = static_cast<ItsPerfCounter>(i);
+                bool software = (counter == ItsPerfCounter::PageFaults || counter == ItsPerfCounter::ContextSwitches);
+                int fd = ItsPerfCounters::Open(counter, this->m_leader, !software);
+                if (fd < 0 && counter == ItsPerfCounter::PageFaults) {
+                    fd = ItsPerfCounters::Open(counter, this->m_leader, true);
+                }
+                if (fd < 0 && counter == ItsPerfCounter::ContextSwitches) {
+                    this->m_rusageSwitches = true;
+                    continue;
+                }
+                if (fd < 0) {
+                    if (this->m_error == 0) {
+                        this->m_error = errno;
+                    }
+                    continue;
+                }
+                this->m_fds[i] = fd;
+                if (this->m_leader == -1) {
+                    this->m_leader = fd;
+                }
+                this->m_order[this->m_opened++] = i;
+            }
+        }
+
+        ~ItsPerfCounters()
+        {
+            for (int fd : this->m_fds) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+            }
+        }
+
+        ItsPerfCounters(const ItsPerfCounters&) = delete;
+        ItsPerfCounters& operator=(const ItsPerfCounters&) = delete;
+
+        // True if at least one counter could be opened.
+        bool IsAvailable() const
+        {
+            return this->m_leader >= 0;
+        }
+
+        bool IsSupported(ItsPerfCounter counter) const
+        {
+            return this->m_fds[static_cast<size_t>(counter)] >= 0 || (counter == ItsPerfCounter::ContextSwitches && this->m_rusageSwitches);
+        }
+
+        // errno of the first counter that could not be opened, 0 if all were (EACCES/EPERM:
+        // restricted by perf_event_paranoid, ENOENT/ENODEV/EOPNOTSUPP: no PMU, ENOSYS: no perf).
+        int GetError() const
+        {
+            return this->m_error;
+        }
+
+        void Start()
+        {
+            if (this->m_rusageSwitches) {
+                this->m_startSwitches = ItsPerfCounters::GetThreadSwitches();
+            }
+            if (this->IsAvailable()) {
+                ioctl(this->m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(this->m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+            this->m_timer.Start();
+        }
+
+        void Stop()
+        {
+            this->m_timer.Stop();
+            this->m_sample = ItsPerfSample();
+            this->m_sample.Error = this->m_error;
+            if (this->IsAvailable()) {
+                ioctl(this->m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+                int error = this->Read(this->m_sample.Values);
+                if (error == 0) {
+                    for (size_t i = 0; i < CounterCount; i++) {
+                        this->m_sample.Valid[i] = (this->m_fds[i] >= 0);
+                    }
+                }
+                else {
+                    std::fill(std::begin(this->m_sample.Values), std::end(this->m_sample.Values), 0);
+                    this->m_sample.Error = error;
+                }
+            }
+            if (this->m_rusageSwitches) {
+                size_t i = static_cast<size_t>(ItsPerfCounter::ContextSwitches);
+                this->m_sample.Values[i] = ItsPerfCounters::GetThreadSwitches() - this->m_startSwitches;
+                this->m_sample.Valid[i] = true;
+            }
+            this->m_sample.Nanoseconds = this->m_timer.GetNanoseconds();
+        }
+
+        //
+        // Method: GetSample
+        //
+        // (i): Result of the last Start/Stop with per iteration values over iterations.
+        //
+        ItsPerfSample GetSample(uint64_t iterations = 1) const
+        {
+            ItsPerfSample sample = this->m_sample;
+            sample.Iterations = iterations;
+            return sample;
+        }
+    };
+
+    //
+    // class: ItsLatencyHistogram
+    //
+    // (i): HDR style log-linear histogram of nanosecond latencies: exact below 32 ns,
+    //      then 32 buckets per power of two (under 3.2% error), up to 2^40 ns (~18 min,
+    //      larger values are clamped). Counters are atomics written by a single owning
+    //      thread with relaxed load/store, so other threads can merge while it records.
+    //
+    class ItsLatencyHistogram
+    {
+    public:
+        static constexpr int SubBucketBits = 5;
+        static constexpr int MaxBits = 40;
+        static constexpr size_t SubBuckets = size_t(1) << SubBucketBits;
+        static constexpr size_t BucketCount = (MaxBits - SubBucketBits + 1) * SubBuckets;
+        static constexpr uint64_t MaxValue = (uint64_t(1) << MaxBits) - 1;
+
+    private:
+        std::atomic<uint64_t> m_counts[BucketCount];
+        std::atomic<uint64_t> m_count{ 0 };
+        std::atomic<uint64_t> m_total{ 0 };
+        std::atomic<uint64_t> m_min{ UINT64_MAX };
+        std::atomic<uint64_t> m_max{ 0 };
+
+        static void Add(std::atomic<uint64_t>& a, uint64_t v)
+        {
+            a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+        }
+    public:
+        ItsLatencyHistogram()
+        {
+            for (auto& c : this->m_counts) {
+                c.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        static size_t GetBucket(uint64_t ns)
+        {
+            if (ns < SubBuckets) {
+                return static_cast<size_t>(ns);
+            }
+            if (ns > MaxValue) {
+                ns = MaxValue;
+            }
+            int magnitude = 63 - __builtin_clzll(ns);
+            int shift = magnitude - SubBucketBits;
+            return static_cast<size_t>(shift + 1) * SubBuckets + static_cast<size_t>((ns >> shift) & (SubBuckets - 1));
+        }
+
+        // highest value that lands in bucket
+        static uint64_t GetBucketValue(size_t bucket)
+        {
+            if (bucket < SubBuckets) {
+                return bucket;
+            }
+            int shift = static_cast<int>(bucket / SubBuckets) - 1;
+            uint64_t lower = (SubBuckets + (bucket % SubBuckets)) << shift;
+            return lower + (uint64_t(1) << shift) - 1;
+        }
+
+        //
+        // Method: Record
+        //
+        // (i): Adds one sample. Owning thread only.
+        //
+        void Record(uint64_t ns)
+        {
+            Add(this->m_counts[GetBucket(ns)], 1);
+            Add(this->m_count, 1);
+            Add(this->m_total, ns);
+            if (ns < this->m_min.load(std::memory_order_relaxed)) {
+                this->m_min.store(ns, std::memory_order_relaxed);
+            }
+            if (ns > this->m_max.load(std::memory_order_relaxed)) {
+                this->m_max.store(ns, std::memory_order_relaxed);
+            }
+        }
+
+        //
+        // Method: Merge
+        //
+        // (i): Adds other's samples. Single writer rules apply to this, not to other.
+        //
+        void Merge(const ItsLatencyHistogram& other)
+        {
+            for (size_t i = 0; i < BucketCount; i++) {
+                uint64_t c = other.m_counts[i].load(std::memory_order_relaxed);
+                if (c != 0) {
+                    Add(this->m_counts[i], c);
+                }
+            }
+            Add(this->m_count, other.m_count.load(std::memory_order_relaxed));
+            Add(this->m_total, other.m_total.load(std::memory_order_relaxed));
+            uint64_t min = other.m_min.load(std::memory_order_relaxed);
+            if (min < this->m_min.load(std::memory_order_relaxed)) {
+                this->m_min.store(min, std::memory_order_relaxed);
+            }
+            uint64_t max = other.m_max.load(std::memory_order_relaxed);
+            if (max > this->m_max.load(std::memory_order_relaxed)) {
+                this->m_max.store(max, std::memory_order_relaxed);
+            }
+        }
+
+        void Reset()
+        {
+            for (auto& c : this->m_counts) {
+                c.store(0, std::memory_order_relaxed);
+            }
+            this->m_count.store(0, std::memory_order_relaxed);
+            this->m_total.store(0, std::memory_order_relaxed);
+            this->m_min.store(UINT64_MAX, std::memory_order_relaxed);
+            this->m_max.store(0, std::memory_order_relaxed);
+        }
+
+        uint64_t GetCount() const { return this->m_count.load(std::memory_order_relaxed); }
+        uint64_t GetTotal() const { return this->m_total.load(std::memory_order_relaxed); }
+        uint64_t GetMax() const { return this->m_max.load(std::memory_order_relaxed); }
+        uint64_t GetMin() const
+        {
+            return (this->GetCount() == 0) ? 0 : this->m_min.load(std::memory_order_relaxed);
+        }
+
+        //
+        // Method: GetPercentile
+        //
+        // (i): Value at percentile (0-100), as the highest value of its bucket capped
+        //      at the recorded maximum. 0 when empty.
+        //
+        uint64_t GetPercentile(double percentile) const
+        {
+            uint64_t count = this->GetCount();
+            if (count == 0) {
+                return 0;
+            }
+            uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count)));
+            target = std::max<uint64_t>(1, std::min(target, count));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BucketCount; i++) {
+                seen += this->m_counts[i].load(std::memory_order_relaxed);
+                if (seen >= target) {
+                    return std::min(GetBucketValue(i), this->GetMax());
+                }
+            }
+            return this->GetMax();
+        }
+    };
+
+    //
+    // struct: ItsProfilerStats
+    //
+    // (i): Merged numbers of one ItsProfiler site, times in nanoseconds.
+    //
+    struct ItsProfilerStats
+    {
+        string Name;
+        uint64_t Count = 0;
+        uint64_t Total = 0;
+        uint64_t Min = 0;
+        uint64_t Max = 0;
+        uint64_t P50 = 0;
+        uint64_t P99 = 0;
+        uint64_t P999 = 0;
+
+        uint64_t GetMean() const
+        {
+            return (this->Count == 0) ? 0 : this->Total / this->Count;
+        }
+    };
+
+    //
+    // class: ItsProfilerSite
+    //
+    // (i): One named profiling site. Every recording thread gets its own histogram,
+    //      registered here so GetStats can merge them; a thread's histogram is folded
+    //      into the retired histogram when the thread exits.
+    //
+    class ItsProfilerSite
+    {
+    private:
+        string m_name;
+        size_t m_index;
+        std::mutex m_mutex;
+        vector<unique_ptr<ItsLatencyHistogram>> m_live;
+        ItsLatencyHistogram m_retired;
+
+        struct ThreadHistograms
+        {
+            vector<std::pair<ItsProfilerSite*, ItsLatencyHistogram*>> Sites;
+
+            ~ThreadHistograms()
+            {
+                for (auto& [site, histogram] : this->Sites) {
+                    if (site != nullptr) {
+                        site->Retire(histogram);
+                    }
+                }
+            }
+        };
+
+        ItsLatencyHistogram* Attach()
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->m_live.push_back(make_unique<ItsLatencyHistogram>());
+            return this->m_live.back().get();
+        }
+        void Retire(ItsLatencyHistogram* histogram)
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->m_retired.Merge(*histogram);
+            auto it = std::find_if(this->m_live.begin(), this->m_live.end(),
+                [histogram](const unique_ptr<ItsLatencyHistogram>& h) { return h.get() == histogram; });
+            if (it != this->m_live.end()) {
+                this->m_live.erase(it);
+            }
+        }
+    public:
+        ItsProfilerSite(const string& name, size_t index)
+            : m_name(name), m_index(index)
+        {
+        }
+
+        ItsProfilerSite(const ItsProfilerSite&) = delete;
+        ItsProfilerSite& operator=(const ItsProfilerSite&) = delete;
+
+        const string& GetName() const
+        {
+            return this->m_name;
+        }
+
+        //
+        // Method: Record
+        //
+        // (i): Adds one sample to the calling thread's histogram for this site.
+        //
+        void Record(uint64_t ns)
+        {
+            static thread_local ThreadHistograms local;
+            if (this->m_index >= local.Sites.size()) {
+                local.Sites.resize(this->m_index + 1, { nullptr, nullptr });
+            }
+            auto& slot = local.Sites[this->m_index];
+            if (slot.second == nullptr) {
+                slot = { this, this->Attach() };
+            }
+            slot.second->Record(ns);
+        }
+
+        ItsProfilerStats GetStats()
+        {
+            ItsLatencyHistogram merged;
+            {
+                std::lock_guard<std::mutex> lock(this->m_mutex);
+                merged.Merge(this->m_retired);
+                for (auto& h : this->m_live) {
+                    merged.Merge(*h);
+                }
+            }
+            ItsProfilerStats stats;
+            stats.Name = this->m_name;
+            stats.Count = merged.GetCount();
+            stats.Total = merged.GetTotal();
+            stats.Min = merged.GetMin();
+            stats.Max = merged.GetMax();
+            stats.P50 = merged.GetPercentile(50.0);
+            stats.P99 = merged.GetPercentile(99.0);
+            stats.P999 = merged.GetPercentile(99.9);
+            return stats;
+        }
+
+        // (i): Clears all threads' samples; samples recorded concurrently may survive.
+        void Reset()
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->m_retired.Reset();
+            for (auto& h : this->m_live) {
+                h->Reset();
+            }
+        }
+    };
+
+    //
+    // struct: ItsProfiler
+    //
+    // (i): Registry of ItsProfilerSite's for always-on profiling of hot paths: a scope
+    //      costs two ItsTscClock reads and a few relaxed stores, with no I/O or locks
+    //      after a thread's first sample at a site. Use ITS_PROFILE_SCOPE("name").
+    //      Sites live for the whole process.
+    //
+    struct ItsProfiler
+    {
+    private:
+        struct Registry
+        {
+            std::mutex Mutex;
+            vector<unique_ptr<ItsProfilerSite>> Sites;
+            std::atomic<bool> Enabled{ true };
+        };
+        static Registry& GetRegistry()
+        {
+            // (i): Never destroyed, exiting threads may still retire histograms into sites.
+            static Registry* registry = new Registry();
+            return *registry;
+        }
+    public:
+        //
+        // Function: GetSite
+        //
+        // (i): Returns the site named name, created on first use. Call once per call site
+        //      and keep the reference (ITS_PROFILE_SCOPE keeps it in a static).
+        //
+        static ItsProfilerSite& GetSite(const string& name)
+        {
+            Registry& registry = ItsProfiler::GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.Mutex);
+            for (auto& site : registry.Sites) {
+                if (site->GetName() == name) {
+                    return *site;
+                }
+            }
+            registry.Sites.push_back(make_unique<ItsProfilerSite>(name, registry.Sites.size()));
+            return *registry.Sites.back();
+        }
+
+        static void SetEnabled(bool enabled)
+        {
+            ItsProfiler::GetRegistry().Enabled.store(enabled, std::memory_order_relaxed);
+        }
+
+        static bool IsEnabled()
+        {
+            return ItsProfiler::GetRegistry().Enabled.load(std::memory_order_relaxed);
+        }
+
+        static vector<ItsProfilerStats> GetStats()
+        {
+            vector<ItsProfilerSite*> sites;
+            {
+                Registry& registry = ItsProfiler::GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.Mutex);
+                for (auto& site : registry.Sites) {
+                    sites.push_back(site.get());
+                }
+            }
+            vector<ItsProfilerStats> stats;
+            for (auto site : sites) {
+                stats.push_back(site->GetStats());
+            }
+            return stats;
+        }
+
+        static void Reset()
+        {
+            Registry& registry = ItsProfiler::GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.Mutex);
+            for (auto& site : registry.Sites) {
+                site->Reset();
+            }
+        }
+
+        //
+        // Function: ToString
+        //
+        // (i): Text table of all sites, one line per site, times in microseconds.
+        //
+        static string ToString()
+        {
+            std::stringstream ss;
+            ss << std::left << std::setw(32) << "Site" << std::right
+               << std::setw(12) << "Count" << std::setw(14) << "Total(ms)" << std::setw(12) << "Mean(us)"
+               << std::setw(12) << "P50(us)" << std::setw(12) << "P99(us)" << std::setw(12) << "P999(us)"
+               << std::setw(12) << "Max(us)" << '\n';
+            ss << std::fixed << std::setprecision(3);
+            for (const auto& s : ItsProfiler::GetStats()) {
+                ss << std::left << std::setw(32) << s.Name << std::right
+                   << std::setw(12) << s.Count << std::setw(14) << s.Total / 1e6 << std::setw(12) << s.GetMean() / 1e3
+                   << std::setw(12) << s.P50 / 1e3 << std::setw(12) << s.P99 / 1e3 << std::setw(12) << s.P999 / 1e3
+                   << std::setw(12) << s.Max / 1e3 << '\n';
+            }
+            return ss.str();
+        }
+
+        //
+        // Function: ToJson
+        //
+        // (i): JSON array of all sites, times in nanoseconds.
+        //
+        static string ToJson()
+        {
+            string json("[");
+            bool first = true;
+            for (const auto& s : ItsProfiler::GetStats()) {
+                json += first ? "\n  {\"name\":\"" : ",\n  {\"name\":\"";
+                first = false;
+                ItsString::AppendJsonEscaped(json, s.Name);
+                json += "\",\"count\":" + std::to_string(s.Count);
+                json += ",\"total_ns\":" + std::to_string(s.Total);
+                json += ",\"mean_ns\":" + std::to_string(s.GetMean());
+                json += ",\"min_ns\":" + std::to_string(s.Min);
+                json += ",\"p50_ns\":" + std::to_string(s.P50);
+                json += ",\"p99_ns\":" + std::to_string(s.P99);
+                json += ",\"p999_ns\":" + std::to_string(s.P999);
+                json += ",\"max_ns\":" + std::to_string(s.Max) + "}";
+            }
+            json += first ? "]" : "\n]";
+            return json;
+        }
+    };
+
+    //
+    // class: ItsProfilerScope
+    //
+    // (i): Records the lifetime of the scope into an ItsProfilerSite.
+    //
+    class ItsProfilerScope
+    {
+    private:
+        ItsProfilerSite* m_site;
+        ItsTscClock::time_point m_start;
+    public:
+        explicit ItsProfilerScope(ItsProfilerSite& site)
+            : m_site(ItsProfiler::IsEnabled() ? &site : nullptr)
+        {
+            if (this->m_site != nullptr) {
+                this->m_start = ItsTscClock::now();
+            }
+        }
+
+        ~ItsProfilerScope()
+        {
+            if (this->m_site != nullptr) {
+                auto elapsed = ItsTscClock::now() - this->m_start;
+                this->m_site->Record(static_cast<uint64_t>(std::max<int64_t>(0, elapsed.count())));
+            }
+        }
+
+        ItsProfilerScope(const ItsProfilerScope&) = delete;
+        ItsProfilerScope& operator=(const ItsProfilerScope&) = delete;
+    };
+
+    //
+    // ITS_PROFILE_SCOPE
+    //
+    // (i): Profiles the rest of the enclosing scope under name. Define ITS_NO_PROFILE to
+    //      compile it out.
+    //
+    #ifndef ITS_NO_PROFILE
+    #define ITS_PROFILE_SCOPE(name) \
+        static ItSoftware::Linux::Core::ItsProfilerSite& ITS_CONCAT(its_profile_site_, __LINE__) = ItSoftware::Linux::Core::ItsProfiler::GetSite(name); \
+        ItSoftware::Linux::Core::ItsProfilerScope ITS_CONCAT(its_profile_scope_, __LINE__)(ITS_CONCAT(its_profile_site_, __LINE__))
+    #else
+    #define ITS_PROFILE_SCOPE(name) do {} while (0)
+    #endif
+
+    //
+    // struct: ItsGuidFormat
+    //
+    // (i): Container for premade Guid format strings.
+    //
+    struct ItsGuidFormat {
+        inline static constexpr const char* MicrosoftRegistryFormat{"{%08lX-%04X-%04x-%02X%02X-%02X%02X%02X%02X%02X%02X}"};
+        inline static constexpr const char* MicrosoftRegistryFormatStripped{ "%08lX-%04X-%04x-%02X%02X-%02X%02X%02X%02X%02X%02X" };
+        inline static constexpr const char* MicrosoftConstFormat{ "{ 0x%lx, 0x%x, 0x%x, { 0x%x, 0x%x, 0x%x, 0x%x, 0x%x, 0x%x, 0x%x, 0x%x } }" };
+        inline static constexpr const char* MicrosoftCompactFormat{ "%08lX%04X%04x%02X%02X%02X%02X%02X%02X%02X%02X" };
+        inline static constexpr const char* MicrosoftPrefixedCompactFormat{ "GUID%08lX%04X%04x%02X%02X%02X%02X%02X%02X%02X%02X" };
+    };
+
+    //
+    // struct: ItsGuidValue
+    //
+    // (i): Compact 16 byte Guid in RFC 9562 byte order (same layout as uuid_t) with
+    //      comparison and hashing, for use as a key without rendering to a string.
+    //      Ordering is bytewise, so version 7 values sort by creation time.
+    //
+    struct ItsGuidValue
+    {
+        uint8_t Bytes[16]{ 0 };
+
+        static ItsGuidValue FromUuid(const uuid_t guid)
+        {
+            ItsGuidValue value;
+            memcpy(value.Bytes, guid, sizeof(value.Bytes));
+            return value;
+        }
+        void CopyTo(uuid_t guid) const
+        {
+            memcpy(guid, this->Bytes, sizeof(this->Bytes));
+        }
+        bool IsEmpty() const
+        {
+            uint64_t hi, lo;
+            memcpy(&hi, &this->Bytes[0], sizeof(hi));
+            memcpy(&lo, &this->Bytes[8], sizeof(lo));
+            return (hi | lo) == 0;
+        }
+        int GetVersion() const
+        {
+            return this->Bytes[6] >> 4;
+        }
+        uint64_t Hash() const
+        {
+            uint64_t hi, lo;
+            memcpy(&hi, &this->Bytes[0], sizeof(hi));
+            memcpy(&lo, &this->Bytes[8], sizeof(lo));
+            uint64_t h = (hi ^ (lo * 0x9E3779B97F4A7C15ULL)) * 0xBF58476D1CE4E5B9ULL;
+            return h ^ (h >> 31);
+        }
+        int Compare(const ItsGuidValue& other) const
+        {
+            return memcmp(this->Bytes, other.Bytes, sizeof(this->Bytes));
+        }
+
+        //
+        // Method: ToString
+        //
+        // (i): Renders the canonical lower case 8-4-4-4-12 form (as uuid_unparse_lower)
+        //      into buffer, zero terminated. Returns the length, or 0 if buffer is too small.
+        //
+        static constexpr size_t StringBufferSize = 37;
+
+        size_t ToString(char* buffer, size_t size) const
+        {
+            if (size < ItsGuidValue::StringBufferSize) {
+                return 0;
+            }
+            char* p = buffer;
+            p += ItsHex::Encode(&this->Bytes[0], 4, p);
+            *p++ = '-';
+            p += ItsHex::Encode(&this->Bytes[4], 2, p);
+            *p++ = '-';
+            p += ItsHex::Encode(&this->Bytes[6], 2, p);
+            *p++ = '-';
+            p += ItsHex::Encode(&this->Bytes[8], 2, p);
+            *p++ = '-';
+            p += ItsHex::Encode(&this->Bytes[10], 6, p);
+            *p = '\0';
+            return static_cast<size_t>(p - buffer);
+        }
+        string ToString() const
+        {
+            char buffer[ItsGuidValue::StringBufferSize];
+            size_t length = this->ToString(buffer, sizeof(buffer));
+            return string(buffer, length);
+        }
+
+        bool operator==(const ItsGuidValue& other) const { return this->Compare(other) == 0; }
+        bool operator!=(const ItsGuidValue& other) const { return this->Compare(other) != 0; }
+        bool operator<(const ItsGuidValue& other) const { return this->Compare(other) < 0; }
+        bool operator<=(const ItsGuidValue& other) const { return this->Compare(other) <= 0; }
+        bool operator>(const ItsGuidValue& other) const { return this->Compare(other) > 0; }
+        bool operator>=(const ItsGuidValue& other) const { return this->Compare(other) >= 0; }
+    };
+
+    //
+    // struct: ItsGuidValueHash
+    //
+    // (i): Hash functor for ItsGuidValue keys in unordered containers.
+    //
+    struct ItsGuidValueHash
+    {
+        size_t operator()(const ItsGuidValue& value) const
+        {
+            return static_cast<size_t>(value.Hash());
+        }
+    };
+
+    //
+    // class: ItsGuidGenerator
+    //
+    // (i): Per thread, lock free generator for version 4 (random) and version 7 (unix
+    //      time ordered) Guids. Each thread owns an ItsXoshiro256StarStar whose whole
+    //      256 bit state comes from getrandom, so the 122 random bits of a version 4
+    //      value are not limited by a 64 bit state and streams of different threads
+    //      or processes do not overlap in practice. Reseeded in a forked child
+    //      (ItsForkGeneration) so parent and child never share a sequence.
+    //      Version 7 values are strictly increasing per thread: the 12 bit rand_a field
+    //      is a counter within the millisecond (RFC 9562, method 1).
+    //      Not intended as a source of secrets, use libuuid or getrandom for those.
+    //
+    class ItsGuidGenerator
+    {
+    private:
+        ItsXoshiro256StarStar m_random;
+        uint64_t m_lastMilliseconds = 0;
+        uint32_t m_counter = 0;
+        uint32_t m_generation = 0;
+        bool m_seeded = false;
+
+        void Seed()
+        {
+            uint64_t state[4]{ 0, 0, 0, 0 };
+            if (getrandom(state, sizeof(state), 0) != static_cast<ssize_t>(sizeof(state)) || !this->m_random.SetState(state)) {
+                timespec ts{};
+                clock_gettime(CLOCK_MONOTONIC, &ts);
+                this->m_random.Seed((static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec) ^
+                                    (static_cast<uint64_t>(getpid()) << 32) ^ reinterpret_cast<uintptr_t>(this));
+            }
+            this->m_lastMilliseconds = 0;
+            this->m_generation = ItsForkGeneration::Get();
+            this->m_seeded = true;
+        }
+        void EnsureSeeded()
+        {
+            if (!this->m_seeded || this->m_generation != ItsForkGeneration::Get()) {
+                this->Seed();
+            }
+        }
+        uint64_t NextRandom()
+        {
+            return this->m_random();
+        }
+        static uint64_t NowMilliseconds()
+        {
+            timespec ts{};
+            clock_gettime(CLOCK_REALTIME, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1000ULL + static_cast<uint64_t>(ts.tv_nsec) / 1000000ULL;
+        }
+        static void Store(ItsGuidValue& value, uint64_t hi, uint64_t lo)
+        {
+            hi = htobe64(hi);
+            lo = htobe64(lo);
+            memcpy(&value.Bytes[0], &hi, sizeof(hi));
+            memcpy(&value.Bytes[8], &lo, sizeof(lo));
+        }
+        void NextV4(ItsGuidValue& value)
+        {
+            uint64_t hi = (this->NextRandom() & 0xFFFFFFFFFFFF0FFFULL) | 0x0000000000004000ULL;
+            uint64_t lo = (this->NextRandom() & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;
+            ItsGuidGenerator::Store(value, hi, lo);
+        }
+        void NextV7(ItsGuidValue& value, uint64_t now)
+        {
+            if (now > this->m_lastMilliseconds) {
+                this->m_lastMilliseconds = now;
+                // (i): Start below 0x800 to leave room for at least 2048 values per millisecond.
+                this->m_counter = static_cast<uint32_t>(this->NextRandom() & 0x7FF);
+            }
+            else if (++this->m_counter > 0xFFF) {
+                // (i): Counter exhausted, or the clock went back; borrow the next millisecond.
+                this->m_lastMilliseconds++;
+                this->m_counter = 0;
+            }
+            uint64_t hi = ((this->m_lastMilliseconds & 0xFFFFFFFFFFFFULL) << 16) | 0x7000ULL | this->m_counter;
+            uint64_t lo = (this->NextRandom() & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;
+            ItsGuidGenerator::Store(value, hi, lo);
+        }
+    public:
+        //
+        // Function: ThreadLocal
+        //
+        // (i): Returns the calling thread's generator.
+        //
+        static ItsGuidGenerator& ThreadLocal()
+        {
+            static thread_local ItsGuidGenerator generator;
+            return generator;
+        }
+
+        ItsGuidValue NewV4()
+        {
+            ItsGuidValue value;
+            this->EnsureSeeded();
+            this->NextV4(value);
+            return value;
+        }
+        ItsGuidValue NewV7()
+        {
+            ItsGuidValue value;
+            this->EnsureSeeded();
+            this->NextV7(value, ItsGuidGenerator::NowMilliseconds());
+            return value;
+        }
+
+        //
+        // Method: FillV4
+        //
+        // (i): Fills values with count version 4 Guids.
+        //
+        void FillV4(ItsGuidValue* values, size_t count)
+        {
+            this->EnsureSeeded();
+            for (size_t i = 0; i < count; i++) {
+                this->NextV4(values[i]);
+            }
+        }
+
+        //
+        // Method: FillV7
+        //
+        // (i): Fills values with count increasing version 7 Guids, reading the clock once
+        //      per 256 values.
+        //
+        void FillV7(ItsGuidValue* values, size_t count)
+        {
+            this->EnsureSeeded();
+            uint64_t now = 0;
+            for (size_t i = 0; i < count; i++) {
+                if ((i & 0xFF) == 0) {
+                    now = ItsGuidGenerator::NowMilliseconds();
+                }
+                this->NextV7(values[i], now);
+            }
+        }
+    };
+
+    //
+    // struct: ItsGuid
+    //
+    // (i): Wrapper for Guid generation and rendering.
+    //
+    struct ItsGuid
+    {
+    public:
+        static string CreateGuid()
+        {
+            uuid_t guid{0};
+            uuid_generate(guid);
+            return ItsGuid::ToString(guid);
+        }
+        static bool CreateGuid(uuid_t pGuid)
+        {
+            uuid_generate_random(pGuid);
+            return true;
+        }
+
+        //
+        // Function: CreateGuidValue
+        //
+        // (i): Version 4 or 7 Guid from the calling thread's ItsGuidGenerator, without
+        //      libuuid or string formatting.
+        //
+        static ItsGuidValue CreateGuidValue(int version = 4)
+        {
+            return (version == 7) ? ItsGuidGenerator::ThreadLocal().NewV7() : ItsGuidGenerator::ThreadLocal().NewV4();
+        }
+
+        //
+        // Function: CreateGuidValues
+        //
+        // (i): Bulk generation of count version 4 or 7 Guids into values.
+        //
+        static void CreateGuidValues(ItsGuidValue* values, size_t count, int version = 4)
+        {
+            if (version == 7) {
+                ItsGuidGenerator::ThreadLocal().FillV7(values, count);
+            }
+            else {
+                ItsGuidGenerator::ThreadLocal().FillV4(values, count);
+            }
+        }
+        static vector<ItsGuidValue> CreateGuidValues(size_t count, int version = 4)
+        {
+            vector<ItsGuidValue> values(count);
+            ItsGuid::CreateGuidValues(values.data(), count, version);
+            return values;
+        }
+        static string ToString(const ItsGuidValue& value, const string& format = ItsGuidFormat::MicrosoftRegistryFormat)
+        {
+            uuid_t guid;
+            value.CopyTo(guid);
+            return ItsGuid::ToString(guid, format, true);
+        }
+        static string ToString(uuid_t guid) {
+            return ItsGuid::ToString(guid, ItsGuidFormat::MicrosoftRegistryFormat, true);
+        }
+        static string ToString(uuid_t guid, const string& format, bool isMicrosoftGuidFormat) {
+            char szBuffer[100];
+            size_t length = 0;
+
+            if (isMicrosoftGuidFormat) {
+                length = ItsGuid::ToString(guid, format, szBuffer, sizeof(szBuffer));
+                if (length > 0) {
+                    return string(szBuffer, length);
+                }
+            }
+
+            memset(szBuffer, 0, 100);
+            if (isMicrosoftGuidFormat) {
+                snprintf(szBuffer, 100, format.c_str(),
+                    *reinterpret_cast<uint32_t*>(&guid[0]), *reinterpret_cast<uint16_t*>(&guid[4]), *reinterpret_cast<uint16_t*>(&guid[6]),
+                    guid[8], guid[9], guid[10], guid[11], guid[12], guid[13], guid[14], guid[15]);
+            }
+            else {
+                snprintf(szBuffer, 100, format.c_str(),
+                    guid[0], guid[1], guid[2], guid[3], guid[4], guid[5], guid[6], guid[7],
+                    guid[8], guid[9], guid[10], guid[11], guid[12], guid[13], guid[14], guid[15]);
+            }
+            return string(szBuffer);
+        }
+
+        //
+        // Function: ToString
+        //
+        // (i): printf free rendering of the ItsGuidFormat Microsoft formats into buffer,
+        //      zero terminated, with output identical to the format strings. Returns the
+        //      length, or 0 for another format or a too small buffer.
+        //
+        static constexpr size_t StringBufferSize = 100;
+
+        static size_t ToString(const uuid_t guid, std::string_view format, char* buffer, size_t size)
+        {
+            uint32_t data1;
+            uint16_t data2;
+            uint16_t data3;
+            memcpy(&data1, &guid[0], sizeof(data1));
+            memcpy(&data2, &guid[4], sizeof(data2));
+            memcpy(&data3, &guid[6], sizeof(data3));
+
+            char temp[ItsGuid::StringBufferSize];
+            char* p = temp;
+            bool braces = (format == ItsGuidFormat::MicrosoftRegistryFormat);
+            bool prefix = (format == ItsGuidFormat::MicrosoftPrefixedCompactFormat);
+
+            if (braces || prefix || format == ItsGuidFormat::MicrosoftRegistryFormatStripped ||
+                format == ItsGuidFormat::MicrosoftCompactFormat)
+            {
+                bool dashes = !prefix && format != ItsGuidFormat::MicrosoftCompactFormat;
+                if (braces) {
+                    *p++ = '{';
+                }
+                if (prefix) {
+                    memcpy(p, "GUID", 4);
+                    p += 4;
+                }
+                p = ItsHex::Write(p, data1, 8, true);
+                if (dashes) {
+                    *p++ = '-';
+                }
+                p = ItsHex::Write(p, data2, 4, true);
+                if (dashes) {
+                    *p++ = '-';
+                }
+                // (i): The third group is lower case in the format strings.
+                p = ItsHex::Write(p, data3, 4, false);
+                if (dashes) {
+                    *p++ = '-';
+                }
+                p += ItsHex::Encode(&guid[8], 2, p, true);
+                if (dashes) {
+                    *p++ = '-';
+                }
+                p += ItsHex::Encode(&guid[10], 6, p, true);
+                if (braces) {
+                    *p++ = '}';
+                }
+            }
+            else if (format == ItsGuidFormat::MicrosoftConstFormat)
+            {
+                auto put = [&p](const char* text) {
+                    size_t n = strlen(text);
+                    memcpy(p, text, n);
+                    p += n;
+                };
+                put("{ 0x");
+                p = ItsHex::WriteMinimal(p, data1, false);
+                put(", 0x");
+                p = ItsHex::WriteMinimal(p, data2, false);
+                put(", 0x");
+                p = ItsHex::WriteMinimal(p, data3, false);
+                put(", { 0x");
+                for (int i = 8; i < 16; i++) {
+                    if (i > 8) {
+                        put(", 0x");
+                    }
+                    p = ItsHex::WriteMinimal(p, static_cast<uint8_t>(guid[i]), false);
+                }
+                put(" } }");
+            }
+            else
+            {
+                return 0;
+            }
+
+            size_t length = static_cast<size_t>(p - temp);
+            if (length + 1 > size) {
+                return 0;
+            }
+            memcpy(buffer, temp, length);
+            buffer[length] = '\0';
+            return length;
         }
-        static string ToString(uuid_t guid, const string& format, bool isMicrosoftGuidFormat) {
-            char szBuffer[100];
-            memset(szBuffer, 0, 100);
 
-            if (isMicrosoftGuidFormat) {
-                snprintf(szBuffer, 100, format.c_str(),
-                    *reinterpret_cast<uint32_t*>(&guid[0]), *reinterpret_cast<uint16_t*>(&guid[4]), *reinterpret_cast<uint16_t*>(&guid[6]),
-                    guid[8], guid[9], guid[10], guid[11], guid[12], guid[13], guid[14], guid[15]);
+        //
+        // Function: TryParse
+        //
+        // (i): Parses the registry ("{...}"), stripped, compact and "GUID" prefixed compact
+        //      formats, hex digits in either case, into guid as ToString reads it.
+        //
+        static bool TryParse(std::string_view text, uuid_t guid)
+        {
+            bool dashes = false;
+            if (text.size() == 38 && text.front() == '{' && text.back() == '}') {
+                text = text.substr(1, 36);
+                dashes = true;
+            }
+            else if (text.size() == 36 && (text.substr(0, 4) == "GUID" || text.substr(0, 4) == "guid")) {
+                text.remove_prefix(4);
+            }
+            else if (text.size() == 36) {
+                dashes = true;
+            }
+            else if (text.size() != 32) {
+                return false;
+            }
+
+            char digits[32];
+            if (dashes) {
+                if (text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-') {
+                    return false;
+                }
+                memcpy(digits, text.data(), 8);
+                memcpy(digits + 8, text.data() + 9, 4);
+                memcpy(digits + 12, text.data() + 14, 4);
+                memcpy(digits + 16, text.data() + 19, 4);
+                memcpy(digits + 20, text.data() + 24, 12);
             }
             else {
-                snprintf(szBuffer, 100, format.c_str(),
-                    guid[0], guid[1], guid[2], guid[3], guid[4], guid[5], guid[6], guid[7],
-                    guid[8], guid[9], guid[10], guid[11], guid[12], guid[13], guid[14], guid[15]);
+                memcpy(digits, text.data(), 32);
             }
-            return string(szBuffer);
+
+            uint8_t bytes[16];
+            if (!ItsHex::Decode(std::string_view(digits, 32), bytes, 16)) {
+                return false;
+            }
+
+            uint32_t data1 = (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | bytes[3];
+            uint16_t data2 = static_cast<uint16_t>((bytes[4] << 8) | bytes[5]);
+            uint16_t data3 = static_cast<uint16_t>((bytes[6] << 8) | bytes[7]);
+            memcpy(&guid[0], &data1, sizeof(data1));
+            memcpy(&guid[4], &data2, sizeof(data2));
+            memcpy(&guid[6], &data3, sizeof(data3));
+            memcpy(&guid[8], &bytes[8], 8);
+            return true;
         }
     };
 
@@ -788,6 +2597,29 @@ namespace ItSoftware::Linux::Core
             return true;
         }
 
+        //
+        // Method: GetLineReader
+        //
+        // (i): Lines from the current position in constant memory, see ItsLineReader.
+        //      The file must outlive the reader.
+        //
+        auto GetLineReader(size_t bufferSize = 64 * 1024)
+        {
+            auto source = [this](char* buffer, size_t size) -> ssize_t {
+                if (this->IsInvalid())
+                {
+                    return -1;
+                }
+                ssize_t n;
+                do
+                {
+                    n = read(this->m_fd.p(), buffer, size);
+                } while (n < 0 && errno == EINTR);
+                return n;
+            };
+            return ItsLineReader<decltype(source)>(std::move(source), bufferSize);
+        }
+
         bool SetPosFromBeg(off_t offset)
         {
             if (this->IsInvalid())
@@ -1111,6 +2943,7 @@ namespace ItSoftware::Linux::Core
     // struct: ItsPath
     // 
     // (i): Path routines.
+    //      The *View functions return views into the given path and do not allocate.
     //
     struct ItsPath
     {
@@ -1129,6 +2962,14 @@ namespace ItSoftware::Linux::Core
             chars.push_back('/');
             return chars;
         }
+        static constexpr bool IsInvalidPathCharacter(char c)
+        {
+            return (c == '\0');
+        }
+        static constexpr bool IsInvalidFilenameCharacter(char c)
+        {
+            return (ItsPath::IsInvalidPathCharacter(c) || c == ItsPath::PathSeparator);
+        }
         static string Combine(const string& path1, const string& path2)
         {
             if (path1.size() == 0 && path2.size() == 0) {
@@ -1143,16 +2984,57 @@ namespace ItSoftware::Linux::Core
                 return path1;
             }
 
-            stringstream path;
-            path << path1;
+            string path;
+            path.reserve(path1.size() + path2.size() + 1);
+            path.append(path1);
             if (path1[path1.size() - 1] != ItsPath::PathSeparator &&
                 path2[0] != ItsPath::PathSeparator ) {
-                path << ItsPath::PathSeparator;
+                path.push_back(ItsPath::PathSeparator);
             }
-            path << path2;
+            path.append(path2);
             
-            string retVal = path.str();
-            return retVal;
+            return path;
+        }
+        //
+        // Function: Combine
+        //
+        // (i): Combines path1 and path2 into caller owned buffer. Result is zero terminated.
+        //      Returns false if buffer is too small.
+        //
+        static bool Combine(std::string_view path1, std::string_view path2, char* buffer, size_t bufferSize, size_t* length)
+        {
+            if (buffer == nullptr || bufferSize == 0) {
+                return false;
+            }
+
+            bool addSeparator = (path1.size() > 0 && path2.size() > 0 &&
+                                 path1[path1.size() - 1] != ItsPath::PathSeparator &&
+                                 path2[0] != ItsPath::PathSeparator);
+
+            size_t size = path1.size() + path2.size() + (addSeparator ? 1 : 0);
+            if (size + 1 > bufferSize) {
+                return false;
+            }
+
+            char* p = buffer;
+            memcpy(p, path1.data(), path1.size());
+            p += path1.size();
+            if (addSeparator) {
+                *p++ = ItsPath::PathSeparator;
+            }
+            memcpy(p, path2.data(), path2.size());
+            p += path2.size();
+            *p = '\0';
+
+            if (length != nullptr) {
+                *length = size;
+            }
+            return true;
+        }
+        template<size_t N>
+        static bool Combine(std::string_view path1, std::string_view path2, char (&buffer)[N], size_t* length)
+        {
+            return ItsPath::Combine(path1, path2, buffer, N, length);
         }
         static bool Exists(const string& path)
         {
@@ -1171,94 +3053,75 @@ namespace ItSoftware::Linux::Core
         }
         static string GetDirectory(const string& path) 
         {
-            if (path.size() == 0) {
-                return string("");
-            }
-
-            if (path.find(ItsPath::PathSeparator) == string::npos) {
-                return string("");
-            }
-
-            auto i = path.find_last_of(ItsPath::PathSeparator);
-            if (i == std::string::npos) {
-                return string("");
+            return string(ItsPath::GetDirectoryView(path));
+        }
+        static constexpr std::string_view GetDirectoryView(std::string_view path)
+        {
+            auto i = path.rfind(ItsPath::PathSeparator);
+            if (i == std::string_view::npos) {
+                return std::string_view();
             }
             return path.substr(0, i+1);
         }
         static string GetFilename(const string& path) 
         {
-            if (path.size() == 0) {
-                return string("");
-            }
-            
-            if (path.find(ItsPath::PathSeparator) == string::npos) {
-                return string("");
-            }
-
+            return string(ItsPath::GetFilenameView(path));
+        }
+        static constexpr std::string_view GetFilenameView(std::string_view path)
+        {
             auto i = path.rfind(ItsPath::PathSeparator);
-            if (i == std::string::npos) {
-                return string("");
+            if (i == std::string_view::npos) {
+                return std::string_view();
             }
-            return path.substr(i+1, path.size()-i-1);
+            return path.substr(i+1);
         }
         static string GetExtension(const string& path)
         {
-            if (path.size() == 0) {
-                return string("");
-            }
-
-            if (path.find(ItsPath::PathSeparator) == string::npos) {
-                return string("");
+            return string(ItsPath::GetExtensionView(path));
+        }
+        static constexpr std::string_view GetExtensionView(std::string_view path)
+        {
+            if (path.find(ItsPath::PathSeparator) == std::string_view::npos) {
+                return std::string_view();
             }
 
             auto i = path.rfind(ItsPath::ExtensionSeparator);
-            if (i == std::wstring::npos) {
-                return string("");
+            if (i == std::string_view::npos) {
+                return std::string_view();
             }
-            return path.substr(i, path.size() - i);
+            return path.substr(i);
         }
-        static bool IsPathValid(const string& path)
+        static bool IsPathValid(std::string_view path)
         {
             if (path.size() == 0) {
                 return false;
             }
 
-            string directory = ItsPath::GetDirectory(path);
-            string filename = ItsPath::GetFilename(path);
-            
-            auto invalidPathChars = ItsPath::GetInvalidPathCharacters();
-            auto invalidFileChars = ItsPath::GetInvalidFilenameCharacters();
+            auto directory = ItsPath::GetDirectoryView(path);
+            auto filename = ItsPath::GetFilenameView(path);
                                 
-            if ( directory[directory.size()-1] != ItsPath::PathSeparator ) {
+            if (directory.size() == 0 || directory[directory.size()-1] != ItsPath::PathSeparator ) {
                 return false;
             }
 
-            return std::all_of(directory.begin(), directory.end(), [&](wchar_t d) {
-                return std::none_of(invalidPathChars.begin(), invalidPathChars.end(), [&](wchar_t i) {
-                    return d == i;
-                    });
-                });
-
-            return std::all_of(filename.begin(), filename.end(), [&](wchar_t d) {
-                return std::none_of(invalidFileChars.begin(), invalidFileChars.end(), [&](wchar_t i) {
-                    return d == i;
-                    });
-                });
+            if (std::any_of(directory.begin(), directory.end(), ItsPath::IsInvalidPathCharacter)) {
+                return false;
+            }
 
-            return true;
+            return std::none_of(filename.begin(), filename.end(), ItsPath::IsInvalidFilenameCharacter);
         }
-        static bool HasExtension(const string& path, const string& extension)
+        static bool HasExtension(std::string_view path, std::string_view extension)
         {
             if (path.size() == 0) {
                 return false;
             }
 
-            string ext = ItsPath::GetExtension(path);
+            auto ext = ItsPath::GetExtensionView(path);
             if (ext.size() == 0) {
                 return false;
             }
 
-            return (strcmp(ext.c_str(), extension.c_str()) == 0);
+            return (ext == extension);
         }
         static string ChangeExtension(const string& path, const string& newExtension) 
         {
@@ -1296,28 +3159,27 @@ namespace ItSoftware::Linux::Core
 
         static string GetParentDirectory(const string& path) 
         {
-            if (path.size() == 0) {
-                return string("");
-            }
-
-            auto path_str = ItsPath::GetDirectory(path);
+            return string(ItsPath::GetParentDirectoryView(path));
+        }
+        static constexpr std::string_view GetParentDirectoryView(std::string_view path)
+        {
+            auto path_str = ItsPath::GetDirectoryView(path);
             
             size_t pos1 = path_str.rfind(ItsPath::PathSeparator);
-            if (pos1 == string::npos) {
-                return string("");
+            if (pos1 == std::string_view::npos) {
+                return std::string_view();
             }
 
             size_t pos2 = pos1;
-            if (pos1 == (path_str.size() - 1)) {
+            if (pos1 == (path_str.size() - 1) && pos1 > 0) {
                 pos2 = path_str.rfind(ItsPath::PathSeparator, pos1 - 1);
-                if (pos2 == string::npos) {
+                if (pos2 == std::string_view::npos) {
                     pos2 = pos1;
                 }
             }
 
             return path_str.substr(0, pos2+1);
         }
-
     };
 
     //
@@ -1462,6 +3324,369 @@ namespace ItSoftware::Linux::Core
         }
     };
 
+    //
+    // class: ItsPathCache
+    //
+    // (i): Interns lexically normalized paths as compact integer ids with cached parent links.
+    //      Path comparison and parent lookup become integer operations. Optional realpath
+    //      resolution is cached and invalidated through ItsFileMonitor events.
+    //
+    class ItsPathCache
+    {
+    public:
+        typedef uint32_t PathId;
+        inline static constexpr PathId InvalidId = UINT32_MAX;
+        inline static constexpr uint32_t InvalidationMask = (ItsFileMonitorMask::Attrib|ItsFileMonitorMask::Create|ItsFileMonitorMask::Delete|
+                                                             ItsFileMonitorMask::DeleteSelf|ItsFileMonitorMask::MoveSelf|
+                                                             ItsFileMonitorMask::MovedFrom|ItsFileMonitorMask::MovedTo);
+    private:
+        struct Entry
+        {
+            string Path;
+            PathId Parent;
+            uint32_t Depth;
+            std::atomic<PathId> Resolved;
+        };
+        inline static constexpr size_t ChunkBits = 12;
+        inline static constexpr size_t ChunkSize = (1 << ChunkBits);
+        inline static constexpr size_t MaxChunks = 1024;
+
+        unique_ptr<Entry[]> m_chunks[MaxChunks];
+        std::atomic<uint32_t> m_count{0};
+        std::unordered_map<string, PathId> m_ids;
+        string m_scratch;
+        uint64_t m_generation{0};
+        mutable std::mutex m_lock;
+
+    protected:
+        Entry* GetEntry(PathId id) const
+        {
+            if (id >= this->m_count.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            return &this->m_chunks[id >> ChunkBits][id & (ChunkSize - 1)];
+        }
+
+        static std::string_view GetParentPath(std::string_view normalized)
+        {
+            if (normalized == "/" || normalized == "." || normalized.size() == 0) {
+                return std::string_view();
+            }
+
+            auto i = normalized.rfind(ItsPath::PathSeparator);
+            auto last = (i == std::string_view::npos) ? normalized : normalized.substr(i + 1);
+            if (last == "..") {
+                return std::string_view();
+            }
+
+            if (i == std::string_view::npos) {
+                return std::string_view(".");
+            }
+            if (i == 0) {
+                return std::string_view("/");
+            }
+            return normalized.substr(0, i);
+        }
+
+        // (i): m_lock must be held.
+        PathId InternNormalized(const string& normalized)
+        {
+            auto itr = this->m_ids.find(normalized);
+            if (itr != this->m_ids.end()) {
+                return itr->second;
+            }
+
+            PathId parent = InvalidId;
+            uint32_t depth = 0;
+            auto parentPath = ItsPathCache::GetParentPath(normalized);
+            if (parentPath.size() > 0) {
+                parent = this->InternNormalized(string(parentPath));
+                if (parent == InvalidId) {
+                    return InvalidId;
+                }
+                depth = this->GetEntry(parent)->Depth + 1;
+            }
+
+            PathId id = this->m_count.load(std::memory_order_relaxed);
+            if ((id >> ChunkBits) >= MaxChunks) {
+                return InvalidId;
+            }
+            if (this->m_chunks[id >> ChunkBits] == nullptr) {
+                this->m_chunks[id >> ChunkBits] = make_unique<Entry[]>(ChunkSize);
+            }
+
+            Entry& entry = this->m_chunks[id >> ChunkBits][id & (ChunkSize - 1)];
+            entry.Path = normalized;
+            entry.Parent = parent;
+            entry.Depth = depth;
+            entry.Resolved.store(InvalidId, std::memory_order_relaxed);
+
+            this->m_ids.emplace(normalized, id);
+            this->m_count.store(id + 1, std::memory_order_release);
+            return id;
+        }
+
+        bool IsAncestorOfUnlocked(PathId ancestor, PathId id) const
+        {
+            const Entry* a = this->GetEntry(ancestor);
+            const Entry* e = this->GetEntry(id);
+            if (a == nullptr || e == nullptr) {
+                return false;
+            }
+
+            while (e->Depth > a->Depth) {
+                id = e->Parent;
+                e = this->GetEntry(id);
+            }
+            return (id == ancestor);
+        }
+
+    public:
+        ItsPathCache() = default;
+        ItsPathCache(const ItsPathCache&) = delete;
+        ItsPathCache& operator=(const ItsPathCache&) = delete;
+
+        //
+        // Function: Normalize
+        //
+        // (i): Lexical normalization. Removes empty and "." components and resolves ".."
+        //      against the preceding component. Does not touch the file system.
+        //
+        static void Normalize(std::string_view path, string& normalized)
+        {
+            normalized.clear();
+
+            bool absolute = (path.size() > 0 && path[0] == ItsPath::PathSeparator);
+            if (absolute) {
+                normalized.push_back(ItsPath::PathSeparator);
+            }
+            const size_t base = normalized.size();
+
+            size_t i = 0;
+            while (i < path.size()) {
+                while (i < path.size() && path[i] == ItsPath::PathSeparator) {
+                    i++;
+                }
+                size_t j = i;
+                while (j < path.size() && path[j] != ItsPath::PathSeparator) {
+                    j++;
+                }
+                auto component = path.substr(i, j - i);
+                i = j;
+
+                if (component.size() == 0 || component == ".") {
+                    continue;
+                }
+
+                if (component == "..") {
+                    if (normalized.size() > base) {
+                        auto p = normalized.rfind(ItsPath::PathSeparator);
+                        size_t start = (p == string::npos || p < base) ? base : p + 1;
+                        if (std::string_view(normalized).substr(start) != "..") {
+                            normalized.resize((start == base) ? base : p);
+                            continue;
+                        }
+                    }
+                    else if (absolute) {
+                        continue;
+                    }
+                }
+
+                if (normalized.size() > base) {
+                    normalized.push_back(ItsPath::PathSeparator);
+                }
+                normalized.append(component);
+            }
+
+            if (normalized.size() == 0) {
+                normalized.push_back('.');
+            }
+        }
+
+        static string Normalize(std::string_view path)
+        {
+            string normalized;
+            ItsPathCache::Normalize(path, normalized);
+            return normalized;
+        }
+
+        //
+        // Method: Intern
+        //
+        // (i): Returns the id of the normalized path, adding it and its parents if needed.
+        //
+        PathId Intern(std::string_view path)
+        {
+            std::lock_guard<std::mutex> lock(this->m_lock);
+            ItsPathCache::Normalize(path, this->m_scratch);
+            return this->InternNormalized(this->m_scratch);
+        }
+
+        //
+        // Method: Find
+        //
+        // (i): Returns the id of the normalized path or InvalidId if not interned.
+        //
+        PathId Find(std::string_view path)
+        {
+            std::lock_guard<std::mutex> lock(this->m_lock);
+            ItsPathCache::Normalize(path, this->m_scratch);
+            auto itr = this->m_ids.find(this->m_scratch);
+            return (itr != this->m_ids.end()) ? itr->second : InvalidId;
+        }
+
+        const string& GetPath(PathId id) const
+        {
+            static const string empty;
+            const Entry* e = this->GetEntry(id);
+            return (e != nullptr) ? e->Path : empty;
+        }
+
+        PathId GetParent(PathId id) const
+        {
+            const Entry* e = this->GetEntry(id);
+            return (e != nullptr) ? e->Parent : InvalidId;
+        }
+
+        uint32_t GetDepth(PathId id) const
+        {
+            const Entry* e = this->GetEntry(id);
+            return (e != nullptr) ? e->Depth : 0;
+        }
+
+        //
+        // Method: IsAncestorOf
+        //
+        // (i): True if ancestor is id or one of its parents.
+        //
+        bool IsAncestorOf(PathId ancestor, PathId id) const
+        {
+            return this->IsAncestorOfUnlocked(ancestor, id);
+        }
+
+        size_t Count() const
+        {
+            return this->m_count.load(std::memory_order_acquire);
+        }
+
+        //
+        // Method: Resolve
+        //
+        // (i): Returns the id of realpath(id), cached until invalidated. InvalidId on error.
+        //
+        PathId Resolve(PathId id)
+        {
+            Entry* e = this->GetEntry(id);
+            if (e == nullptr) {
+                return InvalidId;
+            }
+
+            PathId resolved = e->Resolved.load(std::memory_order_acquire);
+            if (resolved != InvalidId) {
+                return resolved;
+            }
+
+            uint64_t generation{0};
+            {
+                std::lock_guard<std::mutex> lock(this->m_lock);
+                generation = this->m_generation;
+            }
+
+            char buffer[PATH_MAX];
+            if (::realpath(e->Path.c_str(), buffer) == nullptr) {
+                return InvalidId;
+            }
+
+            std::lock_guard<std::mutex> lock(this->m_lock);
+            this->m_scratch.assign(buffer);
+            resolved = this->InternNormalized(this->m_scratch);
+            if (resolved != InvalidId && generation == this->m_generation) {
+                e->Resolved.store(resolved, std::memory_order_release);
+            }
+            return resolved;
+        }
+
+        //
+        // Method: Invalidate
+        //
+        // (i): Drops cached resolutions of id, its descendants and paths resolving into them.
+        //
+        void Invalidate(PathId id)
+        {
+            std::lock_guard<std::mutex> lock(this->m_lock);
+            this->m_generation++;
+
+            const uint32_t count = this->m_count.load(std::memory_order_relaxed);
+            for (PathId i = 0; i < count; i++) {
+                Entry* e = this->GetEntry(i);
+                PathId resolved = e->Resolved.load(std::memory_order_relaxed);
+                if (resolved == InvalidId) {
+                    continue;
+                }
+                if (this->IsAncestorOfUnlocked(id, i) || this->IsAncestorOfUnlocked(id, resolved)) {
+                    e->Resolved.store(InvalidId, std::memory_order_release);
+                }
+            }
+        }
+
+        void InvalidateAll()
+        {
+            std::lock_guard<std::mutex> lock(this->m_lock);
+            this->m_generation++;
+
+            const uint32_t count = this->m_count.load(std::memory_order_relaxed);
+            for (PathId i = 0; i < count; i++) {
+                this->GetEntry(i)->Resolved.store(InvalidId, std::memory_order_release);
+            }
+        }
+
+        //
+        // Method: HandleFileMonitorEvent
+        //
+        // (i): Invalidates cached resolutions affected by an event on the monitored directory.
+        //
+        void HandleFileMonitorEvent(std::string_view directory, const inotify_event& event)
+        {
+            if (event.mask & IN_Q_OVERFLOW) {
+                this->InvalidateAll();
+                return;
+            }
+
+            if ((event.mask & ItsPathCache::InvalidationMask) == 0) {
+                return;
+            }
+
+            PathId id = InvalidId;
+            if (event.len > 0) {
+                char buffer[PATH_MAX];
+                if (!ItsPath::Combine(directory, std::string_view(event.name), buffer, nullptr)) {
+                    this->InvalidateAll();
+                    return;
+                }
+                id = this->Find(buffer);
+            }
+            else {
+                id = this->Find(directory);
+            }
+
+            if (id != InvalidId) {
+                this->Invalidate(id);
+            }
+        }
+
+        //
+        // Method: CreateFileMonitorHandler
+        //
+        // (i): Handler for ItsFileMonitor(directory, ItsPathCache::InvalidationMask, handler).
+        //
+        function<void(inotify_event&)> CreateFileMonitorHandler(const string& directory)
+        {
+            return [this, directory](inotify_event& event) {
+                this->HandleFileMonitorEvent(directory, event);
+            };
+        }
+    };
+
     //
     // class: ItsDaemon
     //
@@ -22,12 +22,41 @@
 #include <random>
 #include <functional>
 #include <regex>
-//#include <generator>
 #include <stdlib.h>
+#include <limits.h>
 #include <syslog.h>
 #include <time.h>
 #include <string.h>
+#include <errno.h>
 #include <type_traits>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <string_view>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <map>
+#include <charconv>
+#include <limits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/random.h>
+#include <pthread.h>
+#include <endian.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 //
 // namespace
@@ -57,6 +86,25 @@ namespace ItSoftware::Linux
 	#define AddFlag(val, flag) (val | flag)
 	#define RemoveFlag(val, flag) (val & ~flag)
 
+	//
+	// ItsLog compile time threshold. Log calls below this level compile away.
+	// 0 = Debug, 1 = Information, 2 = Other, 3 = Warning, 4 = Error.
+	//
+	#ifndef ITS_LOG_COMPILE_LEVEL
+	#define ITS_LOG_COMPILE_LEVEL 0
+	#endif
+
+	//
+	// SIMD paths of the string routines, picked from the target flags (-mavx2, -msse2).
+	// Define ITS_NO_SIMD to force the scalar paths.
+	//
+	#if !defined(ITS_NO_SIMD) && defined(__AVX2__)
+	#define ITS_SIMD_AVX2 1
+	#endif
+	#if !defined(ITS_NO_SIMD) && defined(__SSE2__)
+	#define ITS_SIMD_SSE2 1
+	#endif
+
 	//
 	// Function: as_const
 	//
@@ -253,1139 +301,6320 @@ namespace ItSoftware::Linux
 	};
 
 	//
-	// struct: ItsString
+	// struct: ItsStringSearch
 	//
-	// (i): Misc. string routines in one place.
+	// (i): Substring search. Candidates are found by comparing the first and last
+	//      character of the needle 32 (AVX2) or 16 (SSE2) positions at a time and
+	//      only then verified with memcmp. Single characters go to memchr.
 	//
-	struct ItsString
+	struct ItsStringSearch
 	{
-		/* static std::generator<string> StringFromTextByRegex(const string& text, const string& re) {
-			std::regex rgx(re);
-			std::sregex_token_iterator iter(text.begin(), text.end(), rgx);
-			std::sregex_token_iterator end;
-			for (; iter != end; ++iter) {
-				co_yield iter->str();
-			}
-			co_return;
-		}
-
-		static std::generator<wstring> StringFromTextByRegex(const wstring& text, const wstring& re) {
-			std::wregex rgx(re);
-			std::wsregex_token_iterator iter(text.begin(), text.end(), rgx);
-			std::wsregex_token_iterator end;
-			for (; iter != end; ++iter) {
-				co_yield iter->str();
-			}
-			co_return;
-		}
-
-		static std::generator<string> WordsFromText(const string& text) {
-			std::regex rgx(R"(\b\w+\b)");
-			std::sregex_token_iterator iter(text.begin(), text.end(), rgx);
-			std::sregex_token_iterator end;
-			for (; iter != end; ++iter) {
-				co_yield iter->str();
-			}
-			co_return;
-		}
-
-		static std::generator<wstring> WordsFromText(const wstring& text) {
-			std::wregex rgx(LR"(\b\w+\b)");
-			std::wsregex_token_iterator iter(text.begin(), text.end(), rgx);
-			std::wsregex_token_iterator end;
-			for (; iter != end; ++iter) {
-				co_yield iter->str();
-			}
-			co_return;
-		}
-
-		static std::generator<string> LinesFromText(const string& text) {
-			std::regex r("^.*$");
-			string normalized_text = std::regex_replace(text, std::regex("\r\n"), "\n"); // normalize
-			auto words_begin = std::sregex_iterator(normalized_text.begin(), normalized_text.end(), r);
-			auto words_end = std::sregex_iterator();
-
-			for (std::sregex_iterator i = words_begin; i != words_end; ++i) {
-				co_yield i->str();
-			}
+		static constexpr size_t npos = std::string_view::npos;
 
-			co_return;
-		}
-
-		static std::generator<wstring> LinesFromText(const wstring& text) {
-			std::wregex r(L"^.*$");
-			wstring normalized_text = std::regex_replace(text, std::wregex(L"\r\n"), L"\n"); // normalize
-			auto words_begin = std::wsregex_iterator(normalized_text.begin(), normalized_text.end(), r);
-			auto words_end = std::wsregex_iterator();
-
-			for (std::wsregex_iterator i = words_begin; i != words_end; ++i) {
-				co_yield i->str();
-			}
-
-			co_return;
-		} */
-
-		static string WidthExpand(string source, size_t width, char fill, ItsExpandDirection direction)
+		static size_t Find(std::string_view haystack, std::string_view needle, size_t pos = 0)
 		{
-			if (source.size() == 0)
+			const size_t n = haystack.size();
+			const size_t m = needle.size();
+			if (m == 0)
 			{
-				return string("");
+				return (pos <= n) ? pos : npos;
 			}
-			if (width == 0)
+			if (pos > n || m > n - pos)
 			{
-				return string("");
+				return npos;
 			}
 
-			if (source.size() >= width)
+			const char* s = haystack.data();
+			if (m == 1)
 			{
-				return source.substr(0, width);
+				const void* hit = memchr(s + pos, needle[0], n - pos);
+				return (hit != nullptr) ? static_cast<size_t>(static_cast<const char*>(hit) - s) : npos;
 			}
 
-			stringstream result;
-			if (direction == ItsExpandDirection::Left)
+			const char* rest = needle.data() + 1;
+			const size_t restLength = m - 2;
+			const size_t last = n - m;
+			size_t i = pos;
+
+#ifdef ITS_SIMD_AVX2
+			const __m256i first32 = _mm256_set1_epi8(needle[0]);
+			const __m256i last32 = _mm256_set1_epi8(needle[m - 1]);
+			while (i + 32 <= last + 1)
 			{
-				for (size_t i = 0; i < (width - source.size()); i++)
+				__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+				__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + m - 1));
+				uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first32), _mm256_cmpeq_epi8(b, last32))));
+				while (mask != 0)
 				{
-					result << fill;
+					size_t bit = static_cast<size_t>(__builtin_ctz(mask));
+					if (memcmp(s + i + bit + 1, rest, restLength) == 0)
+					{
+						return i + bit;
+					}
+					mask &= mask - 1;
 				}
-				result << source;
+				i += 32;
 			}
-			else if (direction == ItsExpandDirection::Middle)
+#endif
+#ifdef ITS_SIMD_SSE2
+			const __m128i first16 = _mm_set1_epi8(needle[0]);
+			const __m128i last16 = _mm_set1_epi8(needle[m - 1]);
+			while (i + 16 <= last + 1)
 			{
-				for (size_t i = 0; i < ((width - source.size()) / 2); i++)
+				__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + m - 1));
+				uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first16), _mm_cmpeq_epi8(b, last16))));
+				while (mask != 0)
 				{
-					result << fill;
-				}
-
-				result << source;
-
-				for (size_t i = result.str().size(); i < width; i++)
-				{
-					result << fill;
+					size_t bit = static_cast<size_t>(__builtin_ctz(mask));
+					if (memcmp(s + i + bit + 1, rest, restLength) == 0)
+					{
+						return i + bit;
+					}
+					mask &= mask - 1;
 				}
+				i += 16;
 			}
-			else if (direction == ItsExpandDirection::Right)
+#endif
+			for (; i <= last; i++)
 			{
-				result << source;
-
-				for (size_t i = 0; i < (width - source.size()); i++)
+				if (s[i] == needle[0] && s[i + m - 1] == needle[m - 1] && memcmp(s + i + 1, rest, restLength) == 0)
 				{
-					result << fill;
+					return i;
 				}
 			}
-			else
+			return npos;
+		}
+
+		//
+		// Function: Count
+		//
+		// (i): Number of non-overlapping occurrences of needle, 0 for an empty needle.
+		//
+		static size_t Count(std::string_view haystack, std::string_view needle)
+		{
+			if (needle.size() == 0)
 			{
-				return string("");
+				return 0;
 			}
 
-			string retVal = result.str();
-			return retVal;
+			size_t count = 0;
+			size_t pos = ItsStringSearch::Find(haystack, needle, 0);
+			while (pos != npos)
+			{
+				count++;
+				pos = ItsStringSearch::Find(haystack, needle, pos + needle.size());
+			}
+			return count;
 		}
+	};
 
-		static vector<string> Split(string input, const string& delimiter)
+	//
+	// class: ItsStringSplitter
+	//
+	// (i): Lazy split of input on delimiter. Yields string_views into input, which must
+	//      outlive the splitter. Same pieces as ItsString::Split: nothing for an empty
+	//      input or delimiter, otherwise every segment including a trailing empty one.
+	//
+	class ItsStringSplitter
+	{
+	public:
+		class Iterator
 		{
-			vector<string> result;
+		private:
+			std::string_view m_input;
+			std::string_view m_delimiter;
+			size_t m_pos;
+			size_t m_next;
+			bool m_done;
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const std::string_view*;
+			using reference = std::string_view;
+
+			Iterator()
+				: m_pos(0), m_next(0), m_done(true)
+			{
+			}
 
-			if (input.size() == 0 || delimiter.size() == 0) {
-				return result;
+			Iterator(std::string_view input, std::string_view delimiter)
+				: m_input(input), m_delimiter(delimiter), m_pos(0), m_next(0), m_done(input.size() == 0 || delimiter.size() == 0)
+			{
+				if (!this->m_done)
+				{
+					this->m_next = ItsStringSearch::Find(this->m_input, this->m_delimiter, 0);
+				}
 			}
 
-			size_t start = 0;
-			size_t end = input.find(delimiter);
+			std::string_view operator*() const
+			{
+				size_t end = (this->m_next == ItsStringSearch::npos) ? this->m_input.size() : this->m_next;
+				return this->m_input.substr(this->m_pos, end - this->m_pos);
+			}
 
-			while (end != std::string::npos) {
-				result.push_back(input.substr(start, end - start));
-				start = end + delimiter.length();
-				end = input.find(delimiter, start);
+			Iterator& operator++()
+			{
+				if (this->m_next == ItsStringSearch::npos)
+				{
+					this->m_done = true;
+					return *this;
+				}
+				this->m_pos = this->m_next + this->m_delimiter.size();
+				this->m_next = ItsStringSearch::Find(this->m_input, this->m_delimiter, this->m_pos);
+				return *this;
 			}
 
-			// Add the last segment
-			result.push_back(input.substr(start));			
+			Iterator operator++(int)
+			{
+				Iterator it = *this;
+				++(*this);
+				return it;
+			}
 
-			return result;
-		}
+			bool operator==(const Iterator& other) const
+			{
+				if (this->m_done || other.m_done)
+				{
+					return this->m_done == other.m_done;
+				}
+				return this->m_input.data() == other.m_input.data() && this->m_pos == other.m_pos;
+			}
 
-		// to lower case
-		static string ToLowerCase(string s)
-		{
-			std::transform(s.begin(), s.end(), s.begin(), tolower);
-			return s;
-		}
+			bool operator!=(const Iterator& other) const
+			{
+				return !(*this == other);
+			}
+		};
 
-		// to upper case
-		static string ToUpperCase(string s)
-		{
-			std::transform(s.begin(), s.end(), s.begin(), toupper);
-			return s;
-		}
+	private:
+		std::string_view m_input;
+		std::string_view m_delimiter;
 
-		// trim from left
-		static string TrimLeft(string s, const string& t = " \t\n\r\f\v")
+	public:
+		ItsStringSplitter(std::string_view input, std::string_view delimiter)
+			: m_input(input), m_delimiter(delimiter)
 		{
-			s.erase(0, s.find_first_not_of(t));
-			return s;
 		}
 
-		// trim from right
-		static string TrimRight(string s, const string& t = " \t\n\r\f\v")
+		Iterator begin() const
 		{
-			s.erase(s.find_last_not_of(t) + 1);
-			return s;
+			return Iterator(this->m_input, this->m_delimiter);
 		}
 
-		// trim from left & right
-		static string Trim(const string& s, const string& t = " \t\n\r\f\v")
+		Iterator end() const
 		{
-			auto val = TrimRight(s, t);
-			return TrimLeft(val, t);
+			return Iterator();
 		}
+	};
 
-		// left count chars
-		static string Left(string s, uint32_t count)
+	//
+	// class: ItsLineSplitter
+	//
+	// (i): Lazy lines of a text buffer (a string, a mapped file, ...) as string_views.
+	//      Lines end at '\n' and a '\r' before it is dropped. A final line without
+	//      '\n' is yielded; a trailing '\n' does not produce an empty last line.
+	//
+	class ItsLineSplitter
+	{
+	public:
+		class Iterator
 		{
-			if (s.size() == 0 || count == 0)
-			{
-				return string("");
-			}
+		private:
+			const char* m_pos;
+			const char* m_end;
+			std::string_view m_line;
 
-			if (count >= s.size())
+			void Advance()
 			{
-				return s;
-			}
+				if (this->m_pos == this->m_end)
+				{
+					this->m_pos = nullptr;
+					return;
+				}
 
-			stringstream ss;
-			for (uint32_t i = 0; i < count; i++)
-			{
-				ss << s[i];
+				const char* nl = static_cast<const char*>(memchr(this->m_pos, '\n', static_cast<size_t>(this->m_end - this->m_pos)));
+				const char* stop = (nl != nullptr) ? nl : this->m_end;
+				size_t length = static_cast<size_t>(stop - this->m_pos);
+				if (nl != nullptr && length > 0 && stop[-1] == '\r')
+				{
+					length--;
+				}
+				this->m_line = std::string_view(this->m_pos, length);
+				this->m_pos = (nl != nullptr) ? nl + 1 : this->m_end;
 			}
 
-			string str = ss.str();
-			return str;
-		}
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const std::string_view*;
+			using reference = const std::string_view&;
 
-		// mid index, count chars
-		static string Mid(string s, uint32_t index, uint32_t count)
-		{
-			if (s.size() == 0 || count == 0 || index >= s.size())
+			Iterator()
+				: m_pos(nullptr), m_end(nullptr)
 			{
-				return string("");
 			}
 
-			if (index + count >= s.size())
+			explicit Iterator(std::string_view text)
+				: m_pos(text.data()), m_end(text.data() + text.size())
 			{
-				stringstream ss;
-				for (size_t i = index; i < s.size(); i++)
+				if (text.size() == 0)
 				{
-					ss << s[i];
+					this->m_pos = nullptr;
+					return;
 				}
-				string str = ss.str();
-				return str;
+				this->Advance();
 			}
 
-			stringstream ss;
-			for (size_t i = index; i < index + count; i++)
+			const std::string_view& operator*() const
 			{
-				ss << s[i];
+				return this->m_line;
 			}
 
-			string str = ss.str();
-			return str;
-		}
-
-		// right count chars
-		static string Right(string s, uint32_t count)
-		{
-			if (s.size() == 0 || count == 0)
+			Iterator& operator++()
 			{
-				return string("");
+				this->Advance();
+				return *this;
 			}
 
-			if (count >= s.size())
+			bool operator==(const Iterator& other) const
 			{
-				return s;
+				return this->m_pos == other.m_pos;
 			}
 
-			stringstream ss;
-			for (size_t i = s.size() - count; i < s.size(); i++)
+			bool operator!=(const Iterator& other) const
 			{
-				ss << s[i];
+				return !(*this == other);
 			}
+		};
 
-			string str = ss.str();
-			return str;
-		}
+	private:
+		std::string_view m_text;
 
-		static string Replace(string s, const string& replace, const string& replace_with)
+	public:
+		explicit ItsLineSplitter(std::string_view text)
+			: m_text(text)
 		{
-			if (s.size() == 0 || replace.size() == 0 || replace.size() > s.size())
-            {
-                return string("");
-            }
-
-            string retVal = s;
-            size_t index = retVal.find(replace);
-            if (index == string::npos)
-            {
-                return retVal;
-            }
-
-            auto result = ItsString::Split(s, replace);
-            stringstream ss;
-            bool bHit = false;
-            for (const auto& t : result) {
-                if (bHit) {
-                    ss << replace_with;
-                }
-
-                ss << t;
-
-                bHit = true;
-            }
+		}
 
-            return ss.str();
+		Iterator begin() const
+		{
+			return Iterator(this->m_text);
 		}
-	};
 
-	//
-	// enum: DataSizeStringType
-	//
-	// (i): Enum for string representation of ToDataSizeString ItsConvert function.
-	//
-	enum class ItsDataSizeStringType
-	{
-		Recommended,
-		IEC
+		Iterator end() const
+		{
+			return Iterator();
+		}
 	};
 
 	//
-	// struct: ItsConvert
+	// class: ItsWordSplitter
 	//
-	// (i): Misc. convertion routines in one place.
+	// (i): Lazy words of a text buffer as string_views. A word is a run of ASCII
+	//      letters, digits and '_', as \w in std::regex.
 	//
-	struct ItsConvert
+	class ItsWordSplitter
 	{
-		static string ToDataSizeString(size_t size)
-		{
-			return ItsConvert::ToDataSizeString(size, 0);
-		}
-		static string ToDataSizeString(size_t size, int digits)
+	public:
+		static constexpr bool IsWordCharacter(char c)
 		{
-			return ItsConvert::ToDataSizeString(size, digits, ItsDataSizeStringType::Recommended);
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
 		}
-		static string ToDataSizeString(size_t size, int digits, ItsDataSizeStringType type)
-		{
-			if (digits < 0)
-			{
-				digits = 0;
-			}
-			else if (digits > 3)
-			{
-				digits = 3;
-			}
-
-			stringstream ss;
-			double dSize = (double)size;
-
-			int index = 0;
-			while (dSize >= 1024)
-			{
-				dSize /= 1024;
-				index++;
-			}
 
-			vector<string> szSize;
-			if (type == ItsDataSizeStringType::IEC)
-			{
-				szSize = {"Bi", "KiB", "MiB", "GiB", "TiB", "PiB", "EiB", "ZiB", "YiB", "BB", "GP"};
-			}
-			else
-			{ //(type == ItsDataSizeStringType::Recommended) { // defaults to this notation
-				szSize = {"B", "KB", "MB", "GB", "TB", "PB", "EB", "ZB", "YB", "BB", "GP"};
-			}
+		class Iterator
+		{
+		private:
+			const char* m_pos;
+			const char* m_end;
+			std::string_view m_word;
 
-			size_t tst = (size_t)dSize;
-			ss << tst;
-			if (digits > 0)
+			void Advance()
 			{
-				double t = dSize - tst;
-				string ws = ItsConvert::ToString<double>(t);
-				if (ws[0] == '0' && t != 0.0)
+				const char* p = this->m_pos;
+				while (p != this->m_end && !ItsWordSplitter::IsWordCharacter(*p))
 				{
-					ws += "000";
+					p++;
 				}
-				else
+				if (p == this->m_end)
+				{
+					this->m_pos = nullptr;
+					return;
+				}
+				const char* start = p;
+				while (p != this->m_end && ItsWordSplitter::IsWordCharacter(*p))
 				{
-					ws += ".000";
+					p++;
 				}
-				ss << ws.substr(1, digits + 1);
+				this->m_word = std::string_view(start, static_cast<size_t>(p - start));
+				this->m_pos = p;
 			}
-			ss << " ";
-			ss << ((index > (szSize.size() - 1) || index < 0) ? "?" : szSize[index]);
-			
-			string retVal = ss.str();
-			return retVal;
-		}
 
-		template <typename Numeric>
-		static Numeric ToNumber(const string& str)
-		{
-			if (std::is_same_v<Numeric, char>) 
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const std::string_view*;
+			using reference = const std::string_view&;
+
+			Iterator()
+				: m_pos(nullptr), m_end(nullptr)
 			{
-				return static_cast<char>(std::stoi(str));
 			}
-			else if (std::is_same_v<Numeric, unsigned char>)
+
+			explicit Iterator(std::string_view text)
+				: m_pos(text.data()), m_end(text.data() + text.size())
 			{
-				return static_cast<unsigned char>(std::stoi(str));
+				if (text.size() == 0)
+				{
+					this->m_pos = nullptr;
+					return;
+				}
+				this->Advance();
 			}
-			else if (std::is_same_v<Numeric, short>)
+
+			const std::string_view& operator*() const
 			{
-				return static_cast<short>(std::stoi(str));
+				return this->m_word;
 			}
-			else if (std::is_same_v<Numeric, unsigned short>)
+
+			Iterator& operator++()
 			{
-				return static_cast<unsigned short>(std::stoi(str));
+				this->Advance();
+				return *this;
 			}
-			else if (std::is_same_v<Numeric, float>)
+
+			bool operator==(const Iterator& other) const
 			{
-				return std::stof(str);
+				return this->m_pos == other.m_pos;
 			}
-			else if (std::is_same_v<Numeric, double>)
+
+			bool operator!=(const Iterator& other) const
 			{
-				return std::stod(str);
-			}
-			else if (std::is_same_v <Numeric, long double>)
-			{
-				return std::stold(str);
-			}
-			else if (std::is_same_v<Numeric, int>)
-			{
-				return std::stoi(str);
-			}
-			else if (std::is_same_v<Numeric, long>)
-			{
-				return std::stol(str);
-			}
-			else if (std::is_same_v<Numeric, long long>)
-			{
-				return std::stoll(str);
-			}
-			else if (std::is_same_v<Numeric, unsigned int>)
-			{
-				return static_cast<unsigned int>(std::stoul(str));
-			}
-			else if (std::is_same_v<Numeric, unsigned long>)
-			{
-				return std::stoul(str);
-			}
-			else if (std::is_same_v<Numeric, unsigned long long>)
-			{
-				return std::stoull(str);
+				return !(*this == other);
 			}
+		};
 
-			Numeric x = std::stoull(str);
-			return x;
-		}
+	private:
+		std::string_view m_text;
 
-		static int ToLongFromHex(const string& str)
+	public:
+		explicit ItsWordSplitter(std::string_view text)
+			: m_text(text)
 		{
-			char *p;
-			long n = strtol(str.c_str(), &p, 16);
-			if (*p != 0)
-			{
-				return 0;
-			}
-			return n;
 		}
 
-		static string ToString(const bool flag)
+		Iterator begin() const
 		{
-			if (flag)
-			{
-				return string("True");
-			}
-			return string("False");
+			return Iterator(this->m_text);
 		}
 
-		template <typename Numeric>
-		static string ToString(Numeric number)
+		Iterator end() const
 		{
-			stringstream ss;
-			if (std::is_same_v<Numeric, float>)
-			{
-				ss << std::setprecision(std::numeric_limits<float>::digits10);
-			}
-			else if (std::is_same_v<Numeric, double>)
-			{
-				ss << std::setprecision(std::numeric_limits<double>::digits10);
-			}
-			else if (std::is_same_v<Numeric, long double>)
-			{
-				ss << std::setprecision(std::numeric_limits<long double>::digits10);
-			}
-			ss << number;
-
-			string tos = ss.str();
-			return tos;
+			return Iterator();
 		}
+	};
 
-		static string ToStringFormatted(size_t number, char thousandSep = ',')
+	//
+	// class: ItsLineReader
+	//
+	// (i): Lines from a stream of chunks in constant memory. source is called as
+	//      source(char* buffer, size_t size) and returns the number of bytes read,
+	//      0 at end of stream or < 0 on error. Lines follow ItsLineSplitter rules and a
+	//      returned line is valid until the next call to Next. The buffer only grows
+	//      past its initial size to hold a single line longer than it.
+	//
+	template <typename Source>
+	class ItsLineReader
+	{
+	private:
+		Source m_source;
+		vector<char> m_buffer;
+		size_t m_begin;
+		size_t m_end;
+		bool m_eof;
+		bool m_error;
+
+	public:
+		static constexpr size_t DefaultBufferSize = 64 * 1024;
+
+		explicit ItsLineReader(Source source, size_t bufferSize = DefaultBufferSize)
+			: m_source(std::move(source)), m_buffer(bufferSize > 0 ? bufferSize : DefaultBufferSize), m_begin(0), m_end(0), m_eof(false), m_error(false)
 		{
-			string txt = ItsConvert::ToString(number);
+		}
 
-			stringstream ss;
+		ItsLineReader(const ItsLineReader&) = delete;
+		ItsLineReader& operator=(const ItsLineReader&) = delete;
+		ItsLineReader(ItsLineReader&&) = default;
+		ItsLineReader& operator=(ItsLineReader&&) = default;
 
-			int groupSize = 3;
-			int i = groupSize;
-			size_t iCount = 0;
-			size_t iSize = txt.size();
-			for (auto itr = txt.rbegin(); itr < txt.rend(); itr++)
+		//
+		// Method: Next
+		//
+		// (i): Next line, false at end of stream.
+		//
+		bool Next(std::string_view& line)
+		{
+			size_t scanned = this->m_begin;
+			for (;;)
 			{
-				if (i-- > 0)
-				{
-					ss << *itr;
-					iCount++;
-				}
-				else
+				char* data = this->m_buffer.data();
+				const char* nl = static_cast<const char*>(memchr(data + scanned, '\n', this->m_end - scanned));
+				if (nl != nullptr)
 				{
-					if (iCount < iSize)
+					size_t stop = static_cast<size_t>(nl - data);
+					size_t length = stop - this->m_begin;
+					if (length > 0 && data[stop - 1] == '\r')
 					{
-						ss << thousandSep;
-						ss << *itr;
-						iCount++;
-						i = groupSize - 1;
+						length--;
 					}
-					else
+					line = std::string_view(data + this->m_begin, length);
+					this->m_begin = stop + 1;
+					return true;
+				}
+
+				if (this->m_eof)
+				{
+					if (this->m_begin == this->m_end)
 					{
-						i = groupSize;
+						return false;
 					}
+					line = std::string_view(data + this->m_begin, this->m_end - this->m_begin);
+					this->m_begin = this->m_end;
+					return true;
 				}
-			}
-
-			txt = ss.str();
-			stringstream ss2;
-			for (auto itr = txt.rbegin(); itr < txt.rend(); itr++)
-			{
-				ss2 << *itr;
-			}
 
-			string retVal = ss2.str();
+				// (i): Keep the partial line, make room and read more.
+				if (this->m_begin > 0)
+				{
+					memmove(data, data + this->m_begin, this->m_end - this->m_begin);
+					this->m_end -= this->m_begin;
+					this->m_begin = 0;
+				}
+				if (this->m_end == this->m_buffer.size())
+				{
+					this->m_buffer.resize(this->m_buffer.size() * 2);
+					data = this->m_buffer.data();
+				}
+				scanned = this->m_end;
 
-			return retVal;
+				auto n = this->m_source(data + this->m_end, this->m_buffer.size() - this->m_end);
+				if (n > 0)
+				{
+					this->m_end += static_cast<size_t>(n);
+				}
+				else
+				{
+					this->m_error = (n < 0);
+					this->m_eof = true;
+				}
+			}
 		}
 
-		static string ToString(const tm &dateTime)
+		bool HasError() const
 		{
-			stringstream ss;
-			ss << std::setfill('0') << std::setw(4) << (dateTime.tm_year + 1900);
-			ss << "-" << std::setfill('0') << std::setw(2) << (dateTime.tm_mon + 1);
-			ss << "-" << std::setfill('0') << std::setw(2) << dateTime.tm_mday;
-			ss << "T";
-			ss << std::setfill('0') << std::setw(2) << dateTime.tm_hour;
-			ss << ":" << std::setfill('0') << std::setw(2) << dateTime.tm_min;
-			ss << ":" << std::setfill('0') << std::setw(2) << dateTime.tm_sec;
-
-			string tos = ss.str();
-			return tos;
+			return this->m_error;
 		}
 
-		template <typename Numeric>
-		static string ToHexString(Numeric number, bool uppercase = true, uint32_t width = 0, char fillChar = '0', bool showBase = false)
+		class Iterator
 		{
-			stringstream ss;
-			ss << std::hex;
-			if (showBase)
+		private:
+			ItsLineReader* m_reader;
+			std::string_view m_line;
+
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const std::string_view*;
+			using reference = const std::string_view&;
+
+			explicit Iterator(ItsLineReader* reader)
+				: m_reader(reader)
 			{
-				ss << "0x";
+				++(*this);
 			}
-			if (uppercase)
+
+			Iterator()
+				: m_reader(nullptr)
 			{
-				ss << std::uppercase;
 			}
-			if (width > 0)
+
+			const std::string_view& operator*() const
 			{
-				ss << std::setfill(fillChar) << std::setw(width);
+				return this->m_line;
 			}
-			ss << number;
 
-			string tos = ss.str();
-			return tos;
-		}
+			Iterator& operator++()
+			{
+				if (this->m_reader != nullptr && !this->m_reader->Next(this->m_line))
+				{
+					this->m_reader = nullptr;
+				}
+				return *this;
+			}
 
-		static tm ToTM(const string& dateTime)
-		{
-			tm t = {0};
+			bool operator==(const Iterator& other) const
+			{
+				return this->m_reader == other.m_reader;
+			}
 
-			t.tm_year = ItsConvert::ToNumber<int>(dateTime.substr(0, 4)) - 1900;
-			t.tm_mon = ItsConvert::ToNumber<int>(dateTime.substr(5, 2)) - 1;
-			t.tm_mday = ItsConvert::ToNumber<int>(dateTime.substr(8, 2));
-			t.tm_hour = ItsConvert::ToNumber<int>(dateTime.substr(11, 2));
-			t.tm_min = ItsConvert::ToNumber<int>(dateTime.substr(14, 2));
-			t.tm_sec = ItsConvert::ToNumber<int>(dateTime.substr(17, 2));
+			bool operator!=(const Iterator& other) const
+			{
+				return !(*this == other);
+			}
+		};
 
-			return t;
+		Iterator begin()
+		{
+			return Iterator(this);
 		}
 
-		static string ToLowerCase(string text)
+		Iterator end()
 		{
-			std::transform(text.begin(), text.end(), text.begin(), tolower);
-			return text;
+			return Iterator();
 		}
+	};
 
-		static string ToUpperCase(string text)
+	//
+	// struct: ItsString
+	//
+	// (i): Misc. string routines in one place.
+	//
+	struct ItsString
+	{
+		//
+		// Function: LinesFromText
+		//
+		// (i): Lazy lines of text as string_views, see ItsLineSplitter.
+		//
+		static ItsLineSplitter LinesFromText(std::string_view text)
 		{
-			std::transform(text.begin(), text.end(), text.begin(), toupper);
-			return text;
+			return ItsLineSplitter(text);
 		}
 
-		static bool ToBool(string flag)
+		//
+		// Function: WordsFromText
+		//
+		// (i): Lazy words of text as string_views, see ItsWordSplitter.
+		//
+		static ItsWordSplitter WordsFromText(std::string_view text)
 		{
-			flag = ItsConvert::ToLowerCase(flag);
+			return ItsWordSplitter(text);
+		}
 
-			if (!strcmp(flag.c_str(), "true"))
-			{
-				return true;
-			}
-			else if (!strcmp(flag.c_str(), "1"))
+		static string WidthExpand(string source, size_t width, char fill, ItsExpandDirection direction)
+		{
+			if (source.size() == 0)
 			{
-				return true;
+				return string("");
 			}
-			else if (!strcmp(flag.c_str(), "yes"))
+			if (width == 0)
 			{
-				return true;
+				return string("");
 			}
-			else if (!strcmp(flag.c_str(), "on"))
+
+			if (source.size() >= width)
 			{
-				return true;
+				return source.substr(0, width);
 			}
-			return false;
-		}
 
-		static string ToString(const vector<uint64_t> &pks)
-		{
-			stringstream ss;
-			bool bAddSep = false;
-			for (const auto &pk : pks)
+			stringstream result;
+			if (direction == ItsExpandDirection::Left)
 			{
-				if (bAddSep)
+				for (size_t i = 0; i < (width - source.size()); i++)
 				{
-					ss << ";";
+					result << fill;
 				}
-				ss << pk;
-				bAddSep = true;
+				result << source;
 			}
-			string tos = ss.str();
-			return tos;
-		}
+			else if (direction == ItsExpandDirection::Middle)
+			{
+				for (size_t i = 0; i < ((width - source.size()) / 2); i++)
+				{
+					result << fill;
+				}
 
-		static vector<uint64_t> ToPK(const string& pks)
-		{
-			stringstream ss;
-			ss.str(string(pks.begin(), pks.end()));
+				result << source;
 
-			string item;
-			vector<uint64_t> topk;
-			while (getline(ss, item, ';'))
+				for (size_t i = result.str().size(); i < width; i++)
+				{
+					result << fill;
+				}
+			}
+			else if (direction == ItsExpandDirection::Right)
 			{
-				if (!item.empty())
+				result << source;
+
+				for (size_t i = 0; i < (width - source.size()); i++)
 				{
-					topk.push_back(ItsConvert::ToNumber<long long>(string(item.begin(), item.end())));
+					result << fill;
 				}
 			}
+			else
+			{
+				return string("");
+			}
 
-			return topk;
+			string retVal = result.str();
+			return retVal;
 		}
-	};
-
-	//
-	// struct: ItsDateTime
-	//
-	// (i): Represents a date and time.
-	//
-	struct ItsDateTime
-	{
-	private:
-		tm m_tm;
 
-	public:
-		explicit ItsDateTime(tm timeDate)
+		static vector<string> Split(std::string_view input, std::string_view delimiter)
 		{
-			this->m_tm = timeDate;
+			vector<string> result;
+
+			if (input.size() == 0 || delimiter.size() == 0) {
+				return result;
+			}
+
+			result.reserve(ItsStringSearch::Count(input, delimiter) + 1);
+			for (auto part : ItsStringSplitter(input, delimiter)) {
+				result.emplace_back(part);
+			}
+
+			return result;
 		}
 
-		ItsDateTime(const ItsDateTime &dateTime)
+		//
+		// Function: Split
+		//
+		// (i): As Split but fills result with views into input. Returns the number of parts.
+		//
+		static size_t Split(std::string_view input, std::string_view delimiter, vector<std::string_view>& result)
 		{
-			this->m_tm = dateTime.m_tm;
+			result.clear();
+			for (auto part : ItsStringSplitter(input, delimiter)) {
+				result.push_back(part);
+			}
+			return result.size();
 		}
 
-		ItsDateTime(ItsDateTime &&dateTime) noexcept
+		//
+		// Function: SplitView
+		//
+		// (i): Lazy, allocation free split. See ItsStringSplitter.
+		//
+		static ItsStringSplitter SplitView(std::string_view input, std::string_view delimiter)
 		{
-			this->m_tm = dateTime.m_tm;
+			return ItsStringSplitter(input, delimiter);
 		}
 
-		static ItsDateTime Now()
+		//
+		// Function: ConvertAsciiCase
+		//
+		// (i): Flips the case of 'A'..'Z' (Upper = false) or 'a'..'z' (Upper = true) from in to
+		//      out, n bytes. in and out may be the same. Bytes outside ASCII are left alone.
+		//
+		template <bool Upper>
+		static void ConvertAsciiCase(const char* in, char* out, size_t n)
 		{
-			time_t t;
-			time(&t);
-			tm tm2;
-			::localtime_r(&t, &tm2);
-
-			return ItsDateTime(tm2);
+			constexpr char first = Upper ? 'a' : 'A';
+			size_t i = 0;
+#ifdef ITS_SIMD_AVX2
+			const __m256i shift32 = _mm256_set1_epi8(static_cast<char>(128 - first));
+			const __m256i limit32 = _mm256_set1_epi8(static_cast<char>(-128 + 26));
+			const __m256i flip32 = _mm256_set1_epi8(0x20);
+			for (; i + 32 <= n; i += 32) {
+				__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+				__m256i letter = _mm256_cmpgt_epi8(limit32, _mm256_add_epi8(x, shift32));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(x, _mm256_and_si256(letter, flip32)));
+			}
+#endif
+#ifdef ITS_SIMD_SSE2
+			const __m128i shift16 = _mm_set1_epi8(static_cast<char>(128 - first));
+			const __m128i limit16 = _mm_set1_epi8(static_cast<char>(-128 + 26));
+			const __m128i flip16 = _mm_set1_epi8(0x20);
+			for (; i + 16 <= n; i += 16) {
+				__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+				__m128i letter = _mm_cmplt_epi8(_mm_add_epi8(x, shift16), limit16);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(x, _mm_and_si128(letter, flip16)));
+			}
+#endif
+			for (; i < n; i++) {
+				char c = in[i];
+				out[i] = (static_cast<unsigned char>(c - first) < 26) ? static_cast<char>(c ^ 0x20) : c;
+			}
 		}
 
-		bool operator==(const ItsDateTime &other)
+		// to lower case, ASCII only
+		static string ToLowerCase(string s)
 		{
-			if (this->m_tm.tm_year == other.m_tm.tm_year &&
-				this->m_tm.tm_mon == other.m_tm.tm_mon &&
-				this->m_tm.tm_mday == other.m_tm.tm_mday &&
-				this->m_tm.tm_hour == other.m_tm.tm_hour &&
-				this->m_tm.tm_min == other.m_tm.tm_min &&
-				this->m_tm.tm_sec == other.m_tm.tm_sec &&
-				this->m_tm.tm_wday == other.m_tm.tm_wday &&
-				this->m_tm.tm_isdst == other.m_tm.tm_isdst &&
-				this->m_tm.tm_yday == other.m_tm.tm_yday)
-			{
-				return true;
-			}
-			return false;
+			ItsString::ConvertAsciiCase<false>(s.data(), s.data(), s.size());
+			return s;
 		}
 
-		bool operator!=(const ItsDateTime &other)
+		// to upper case, ASCII only
+		static string ToUpperCase(string s)
 		{
-			if (this->m_tm.tm_year == other.m_tm.tm_year &&
-				this->m_tm.tm_mon == other.m_tm.tm_mon &&
-				this->m_tm.tm_mday == other.m_tm.tm_mday &&
-				this->m_tm.tm_hour == other.m_tm.tm_hour &&
-				this->m_tm.tm_min == other.m_tm.tm_min &&
-				this->m_tm.tm_sec == other.m_tm.tm_sec &&
-				this->m_tm.tm_wday == other.m_tm.tm_wday &&
-				this->m_tm.tm_isdst == other.m_tm.tm_isdst &&
-				this->m_tm.tm_yday == other.m_tm.tm_yday)
-			{
+			ItsString::ConvertAsciiCase<true>(s.data(), s.data(), s.size());
+			return s;
+		}
+
+		// to lower case in place
+		static void ToLowerCaseInPlace(string& s)
+		{
+			ItsString::ConvertAsciiCase<false>(s.data(), s.data(), s.size());
+		}
+
+		// to upper case in place
+		static void ToUpperCaseInPlace(string& s)
+		{
+			ItsString::ConvertAsciiCase<true>(s.data(), s.data(), s.size());
+		}
+
+		// to lower case into buffer, which must hold s.size() chars
+		static void ToLowerCase(std::string_view s, char* buffer)
+		{
+			ItsString::ConvertAsciiCase<false>(s.data(), buffer, s.size());
+		}
+
+		// to upper case into buffer, which must hold s.size() chars
+		static void ToUpperCase(std::string_view s, char* buffer)
+		{
+			ItsString::ConvertAsciiCase<true>(s.data(), buffer, s.size());
+		}
+
+		//
+		// Function: EqualsIgnoreCase
+		//
+		// (i): ASCII case-insensitive equality.
+		//
+		static bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+		{
+			if (a.size() != b.size()) {
 				return false;
 			}
+
+			const size_t n = a.size();
+			size_t i = 0;
+#ifdef ITS_SIMD_SSE2
+			const __m128i shift = _mm_set1_epi8(static_cast<char>(128 - 'A'));
+			const __m128i limit = _mm_set1_epi8(static_cast<char>(-128 + 26));
+			const __m128i flip = _mm_set1_epi8(0x20);
+			for (; i + 16 <= n; i += 16) {
+				__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data() + i));
+				__m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + i));
+				x = _mm_or_si128(x, _mm_and_si128(_mm_cmplt_epi8(_mm_add_epi8(x, shift), limit), flip));
+				y = _mm_or_si128(y, _mm_and_si128(_mm_cmplt_epi8(_mm_add_epi8(y, shift), limit), flip));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF) {
+					return false;
+				}
+			}
+#endif
+			for (; i < n; i++) {
+				char x = a[i];
+				char y = b[i];
+				if (x != y) {
+					x = (static_cast<unsigned char>(x - 'A') < 26) ? static_cast<char>(x | 0x20) : x;
+					y = (static_cast<unsigned char>(y - 'A') < 26) ? static_cast<char>(y | 0x20) : y;
+					if (x != y) {
+						return false;
+					}
+				}
+			}
 			return true;
 		}
 
-		const ItsDateTime &operator=(const ItsDateTime &other)
+		//
+		// Function: HashIgnoreCase
+		//
+		// (i): 64-bit hash of the ASCII lower case form of s, 8 bytes per step.
+		//
+		static uint64_t HashIgnoreCase(std::string_view s)
 		{
-			this->m_tm.tm_year = other.m_tm.tm_year;
-			this->m_tm.tm_mon = other.m_tm.tm_mon;
-			this->m_tm.tm_mday = other.m_tm.tm_mday;
-			this->m_tm.tm_hour = other.m_tm.tm_hour;
-			this->m_tm.tm_min = other.m_tm.tm_min;
-			this->m_tm.tm_sec = other.m_tm.tm_sec;
-			this->m_tm.tm_wday = other.m_tm.tm_wday;
-			this->m_tm.tm_isdst = other.m_tm.tm_isdst;
-			this->m_tm.tm_yday = other.m_tm.tm_yday;
+			constexpr uint64_t ones = 0x0101010101010101ULL;
+			auto lower = [](uint64_t x) -> uint64_t {
+				uint64_t heptets = x & (0x7F * ones);
+				uint64_t geA = heptets + (0x80 - 'A') * ones;
+				uint64_t gtZ = heptets + (0x80 - 'Z' - 1) * ones;
+				uint64_t upper = geA & ~gtZ & ~x & (0x80 * ones);
+				return x | (upper >> 2);
+			};
+
+			uint64_t h = 0x9E3779B97F4A7C15ULL ^ s.size();
+			size_t i = 0;
+			for (; i + 8 <= s.size(); i += 8) {
+				uint64_t x;
+				memcpy(&x, s.data() + i, 8);
+				h = (h ^ lower(x)) * 0xFF51AFD7ED558CCDULL;
+				h ^= h >> 32;
+			}
+			if (i < s.size()) {
+				uint64_t x = 0;
+				memcpy(&x, s.data() + i, s.size() - i);
+				h = (h ^ lower(x)) * 0xFF51AFD7ED558CCDULL;
+			}
 
-			return *this;
+			h ^= h >> 33;
+			h *= 0xC4CEB9FE1A85EC53ULL;
+			h ^= h >> 33;
+			return h;
 		}
 
-		explicit operator string() {
-			return this->ToString("s");
+		// trim from left, view into s
+		static std::string_view TrimLeftView(std::string_view s, std::string_view t = " \t\n\r\f\v")
+		{
+			size_t i = 0;
+			while (i < s.size() && t.find(s[i]) != std::string_view::npos) {
+				i++;
+			}
+			return s.substr(i);
 		}
 
-		string ToString()
+		// trim from right, view into s
+		static std::string_view TrimRightView(std::string_view s, std::string_view t = " \t\n\r\f\v")
 		{
-			stringstream ss;
-			ss << std::setfill('0') << std::setw(4) << (this->m_tm.tm_year + 1900);
-			ss << "-" << std::setfill('0') << std::setw(2) << (this->m_tm.tm_mon + 1);
-			ss << "-" << std::setfill('0') << std::setw(2) << this->m_tm.tm_mday;
-			ss << " ";
-			ss << std::setfill('0') << std::setw(2) << this->m_tm.tm_hour;
-			ss << ":" << std::setfill('0') << std::setw(2) << this->m_tm.tm_min;
-			ss << ":" << std::setfill('0') << std::setw(2) << this->m_tm.tm_sec;
+			size_t n = s.size();
+			while (n > 0 && t.find(s[n - 1]) != std::string_view::npos) {
+				n--;
+			}
+			return s.substr(0, n);
+		}
 
-			string tos = ss.str();
-			return tos;
+		// trim from left & right, view into s
+		static std::string_view TrimView(std::string_view s, std::string_view t = " \t\n\r\f\v")
+		{
+			return TrimLeftView(TrimRightView(s, t), t);
 		}
 
-		string ToString(string option)
+		// trim from left
+		static string TrimLeft(std::string_view s, std::string_view t = " \t\n\r\f\v")
 		{
-			if (option == "s" || option == "S")
-			{
-				stringstream ss;
-				ss << std::setfill('0') << std::setw(4) << (this->m_tm.tm_year + 1900);
-				ss << "-" << std::setfill('0') << std::setw(2) << (this->m_tm.tm_mon + 1);
-				ss << "-" << std::setfill('0') << std::setw(2) << this->m_tm.tm_mday;
-				ss << "T";
-				ss << std::setfill('0') << std::setw(2) << this->m_tm.tm_hour;
-				ss << ":" << std::setfill('0') << std::setw(2) << this->m_tm.tm_min;
-				ss << ":" << std::setfill('0') << std::setw(2) << this->m_tm.tm_sec;
+			return string(TrimLeftView(s, t));
+		}
 
-				string tos = ss.str();
-				return tos;
-			}
+		// trim from right
+		static string TrimRight(std::string_view s, std::string_view t = " \t\n\r\f\v")
+		{
+			return string(TrimRightView(s, t));
+		}
 
-			// day
-			int d = this->GetDay();
-			string str_d = ItsConvert::ToString(d);
-			string str_dd;
-			if (d < 10)
-			{
-				str_dd = "0";
-				str_dd += str_d;
-			}
-			else
+		// trim from left & right
+		static string Trim(std::string_view s, std::string_view t = " \t\n\r\f\v")
+		{
+			return string(TrimView(s, t));
+		}
+
+		// left count chars
+		static string Left(string s, uint32_t count)
+		{
+			if (s.size() == 0 || count == 0)
 			{
-				str_dd = str_d;
+				return string("");
 			}
 
-			// month
-			int m = this->GetMonth();
-			string str_m = ItsConvert::ToString(m);
-			string str_mm;
-			if (m < 10)
+			if (count >= s.size())
 			{
-				str_mm = "0";
-				str_mm += str_m;
+				return s;
 			}
-			else
+
+			stringstream ss;
+			for (uint32_t i = 0; i < count; i++)
 			{
-				str_mm = str_m;
+				ss << s[i];
 			}
 
-			// year
-			int y = this->GetYear();
-			string str_yyyy = ItsConvert::ToString(y);
-			string str_yy = ItsString::Right(str_yyyy, 2);
+			string str = ss.str();
+			return str;
+		}
 
-			// hour
-			int h = this->GetHour();
-			string str_h = ItsConvert::ToString(h);
-			string str_hh;
-			if (h < 10)
+		// mid index, count chars
+		static string Mid(string s, uint32_t index, uint32_t count)
+		{
+			if (s.size() == 0 || count == 0 || index >= s.size())
 			{
-				str_hh = "0";
-				str_hh += str_h;
+				return string("");
 			}
-			else
+
+			if (index + count >= s.size())
 			{
-				str_hh = str_h;
+				stringstream ss;
+				for (size_t i = index; i < s.size(); i++)
+				{
+					ss << s[i];
+				}
+				string str = ss.str();
+				return str;
 			}
 
-			// minute
-			int min = this->GetMinute();
-			string str_min = ItsConvert::ToString(min);
-			string str_minmin;
-			if (min < 10)
+			stringstream ss;
+			for (size_t i = index; i < index + count; i++)
 			{
-				str_minmin = "0";
-				str_minmin += str_min;
+				ss << s[i];
 			}
-			else
+
+			string str = ss.str();
+			return str;
+		}
+
+		// right count chars
+		static string Right(string s, uint32_t count)
+		{
+			if (s.size() == 0 || count == 0)
 			{
-				str_minmin = str_min;
+				return string("");
 			}
 
-			// second
-			int s = this->GetSecond();
-			string str_s = ItsConvert::ToString(s);
-			string str_ss;
-			if (s < 10)
+			if (count >= s.size())
 			{
-				str_ss = "0";
-				str_ss += str_s;
+				return s;
 			}
-			else
+
+			stringstream ss;
+			for (size_t i = s.size() - count; i < s.size(); i++)
 			{
-				str_ss = str_s;
+				ss << s[i];
 			}
 
-			string wdd = string("dd");
-			string wd = string("d");
-			option = ItsString::Replace(option, wdd, str_dd);
-			option = ItsString::Replace(option, wd, str_d);
-
-			string wMM = string("MM");
-			string wM = string("M");
-			option = ItsString::Replace(option, wMM, str_mm);
-			option = ItsString::Replace(option, wM, str_m);
+			string str = ss.str();
+			return str;
+		}
 
-			string wyyyy = string("yyyy");
-			string wyy = string("yy");
-			option = ItsString::Replace(option, wyyyy, str_yyyy);
-			option = ItsString::Replace(option, wyy, str_yy);
+		static string Replace(std::string_view s, std::string_view replace, std::string_view replace_with)
+		{
+			if (s.size() == 0 || replace.size() == 0 || replace.size() > s.size())
+            {
+                return string("");
+            }
 
-			string wHH = string("HH");
-			string wH = string("H");
-			option = ItsString::Replace(option, wHH, str_hh);
-			option = ItsString::Replace(option, wH, str_h);
+            size_t index = ItsStringSearch::Find(s, replace);
+            if (index == ItsStringSearch::npos)
+            {
+                return string(s);
+            }
 
-			string wmm = string("mm");
-			string wm = string("m");
-			option = ItsString::Replace(option, wmm, str_minmin);
-			option = ItsString::Replace(option, wm, str_min);
+            size_t count = ItsStringSearch::Count(s.substr(index), replace);
+            string retVal;
+            retVal.reserve(s.size() - count * replace.size() + count * replace_with.size());
 
-			string wss = string("ss");
-			string ws = string("s");
-			option = ItsString::Replace(option, wss, str_ss);
-			option = ItsString::Replace(option, ws, str_s);
+            size_t start = 0;
+            while (index != ItsStringSearch::npos) {
+                retVal.append(s.data() + start, index - start);
+                retVal.append(replace_with.data(), replace_with.size());
+                start = index + replace.size();
+                index = ItsStringSearch::Find(s, replace, start);
+            }
+            retVal.append(s.data() + start, s.size() - start);
 
-			return option;
+            return retVal;
 		}
 
-		const tm &TM()
+		//
+		// Function: AppendJsonEscaped
+		//
+		// (i): Appends s to out as the body of a JSON string: quote, backslash and
+		//      control characters escaped, other bytes (UTF-8) copied as is.
+		//
+		static void AppendJsonEscaped(string& out, std::string_view s)
 		{
-			return this->m_tm;
+			for (char c : s) {
+				switch (c) {
+				case '"': out += "\\\""; break;
+				case '\\': out += "\\\\"; break;
+				case '\n': out += "\\n"; break;
+				case '\r': out += "\\r"; break;
+				case '\t': out += "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20) {
+						out += "\\u00";
+						out += "0123456789abcdef"[(c >> 4) & 0xF];
+						out += "0123456789abcdef"[c & 0xF];
+					}
+					else {
+						out += c;
+					}
+					break;
+				}
+			}
 		}
+	};
 
-		void AddYears(int year)
+	//
+	// struct: ItsHashIgnoreCase / ItsEqualIgnoreCase
+	//
+	// (i): Hash and key-equal for unordered containers with ASCII case-insensitive keys.
+	//
+	struct ItsHashIgnoreCase
+	{
+		size_t operator()(std::string_view s) const
 		{
-			this->m_tm.tm_year += year;
-
-			mktime(&this->m_tm);
+			return static_cast<size_t>(ItsString::HashIgnoreCase(s));
 		}
+	};
 
-		void AddMonths(int month)
+	struct ItsEqualIgnoreCase
+	{
+		bool operator()(std::string_view a, std::string_view b) const
 		{
-			this->m_tm.tm_mon += month;
-
-			mktime(&this->m_tm);
+			return ItsString::EqualsIgnoreCase(a, b);
 		}
+	};
 
-		void AddDays(int day)
+	//
+	// class: ItsPattern
+	//
+	// (i): Regular expression subset compiled to a Thompson NFA and matched by state set
+	//      simulation, so matching is linear in the text length and never backtracks.
+	//      Supported: literals, '.' (any byte but \n and \r), [...] and [^...] classes with
+	//      ranges, \d \w \s \D \W \S \t \n \r \f \v \0 \xhh and escaped punctuation,
+	//      ^ and $ (text begin and end), alternation '|', groups '(...)' and '(?:...)',
+	//      and the * + ? {m} {m,} {m,n} quantifiers (a lazy '?' suffix is accepted).
+	//      Anything else, such as \b, back-references or lookahead, makes the pattern
+	//      invalid rather than being taken literally, so a valid pattern finds what
+	//      std::regex (ECMAScript) finds.
+	//      Patterns without meta characters are searched with ItsStringSearch. Others
+	//      are compiled up front into a DFA (one table lookup per byte) when it stays
+	//      below MaxDfaStates, else the NFA is simulated directly.
+	//
+	class ItsPattern
+	{
+	private:
+		enum class Op : uint8_t
 		{
-			this->m_tm.tm_mday += day;
-
-			mktime(&this->m_tm);
-		}
+			Set,
+			Split,
+			Jump,
+			Begin,
+			End,
+			Match
+		};
+
+		struct Node
+		{
+			Op Code;
+			int Out;
+			int Out1;
+			uint32_t SetIndex;
+		};
 
-		void AddHours(int hour)
+		struct ByteSet
 		{
-			this->m_tm.tm_hour += hour;
+			uint64_t Bits[4] = { 0, 0, 0, 0 };
 
-			mktime(&this->m_tm);
-		}
+			void Add(unsigned char c)
+			{
+				this->Bits[c >> 6] |= (1ULL << (c & 63));
+			}
 
-		void AddMinutes(int min)
-		{
-			this->m_tm.tm_min += min;
+			bool Contains(unsigned char c) const
+			{
+				return (this->Bits[c >> 6] >> (c & 63)) & 1;
+			}
 
-			mktime(&this->m_tm);
-		}
+			void Invert()
+			{
+				for (auto& b : this->Bits)
+				{
+					b = ~b;
+				}
+			}
+		};
 
-		void AddSeconds(int sec)
+		struct Fragment
 		{
-			this->m_tm.tm_sec += sec;
+			int Start;
+			vector<std::pair<int, int>> Outs;
+		};
 
-			mktime(&this->m_tm);
+		struct Dfa
+		{
+			vector<int32_t> Next;
+			vector<uint8_t> Flags;
+			int32_t Start = -1;
+		};
+
+		static constexpr uint8_t AcceptNow = 1;
+		static constexpr uint8_t AcceptAtEnd = 2;
+
+		vector<Node> m_nodes;
+		Dfa m_searchDfa;
+		Dfa m_matchDfa;
+		vector<ByteSet> m_sets;
+		int m_start;
+		bool m_ignoreCase;
+		bool m_literal;
+		string m_expression;
+		string m_error;
+
+		std::string_view m_parse;
+		size_t m_pos;
+
+		static constexpr size_t MaxNodes = 1 << 16;
+		static constexpr size_t MaxDfaStates = 512;
+
+		int AddNode(Op code, int out = -1, int out1 = -1, uint32_t setIndex = 0)
+		{
+			this->m_nodes.push_back(Node{ code, out, out1, setIndex });
+			return static_cast<int>(this->m_nodes.size() - 1);
 		}
 
-		void Add(int year, int month, int day, int hour, int min, int sec)
+		void Patch(const vector<std::pair<int, int>>& outs, int target)
 		{
-			this->m_tm.tm_year += year;
-			this->m_tm.tm_mon += month;
-			this->m_tm.tm_mday += day;
-			this->m_tm.tm_hour += hour;
-			this->m_tm.tm_min += min;
-			this->m_tm.tm_sec += sec;
-
-			mktime(&this->m_tm);
+			for (auto& o : outs)
+			{
+				if (o.second == 0)
+				{
+					this->m_nodes[o.first].Out = target;
+				}
+				else
+				{
+					this->m_nodes[o.first].Out1 = target;
+				}
+			}
 		}
 
-		void SubtractYears(int year)
+		bool Fail(const char* error)
 		{
-			this->m_tm.tm_year -= year;
-
-			mktime(&this->m_tm);
+			if (this->m_error.size() == 0)
+			{
+				this->m_error = error;
+				this->m_error += " at offset ";
+				this->m_error += std::to_string(this->m_pos);
+			}
+			return false;
 		}
 
-		void SubtractMonths(int month)
+		//
+		// (i): With ignoreCase adds the other case of each ASCII letter in set. Must be
+		//      applied to the positive set, before a class is negated.
+		//
+		void FoldCase(ByteSet& set) const
 		{
-			this->m_tm.tm_mon -= month;
-
-			mktime(&this->m_tm);
+			if (this->m_ignoreCase)
+			{
+				for (int c = 'a'; c <= 'z'; c++)
+				{
+					if (set.Contains(static_cast<unsigned char>(c)) || set.Contains(static_cast<unsigned char>(c - 32)))
+					{
+						set.Add(static_cast<unsigned char>(c));
+						set.Add(static_cast<unsigned char>(c - 32));
+					}
+				}
+			}
 		}
 
-		void SubtractDays(int day)
+		// (i): set is final, case folding is done by the caller.
+		Fragment SetFragment(const ByteSet& set)
 		{
-			this->m_tm.tm_mday -= day;
+			this->m_sets.push_back(set);
+			int n = this->AddNode(Op::Set, -1, -1, static_cast<uint32_t>(this->m_sets.size() - 1));
+			return Fragment{ n, { { n, 0 } } };
+		}
+
+		static bool AddEscapeClass(char c, ByteSet& set)
+		{
+			ByteSet s;
+			switch (c)
+			{
+			case 'd':
+			case 'D':
+				for (int i = '0'; i <= '9'; i++)
+				{
+					s.Add(static_cast<unsigned char>(i));
+				}
+				break;
+			case 'w':
+			case 'W':
+				for (int i = 0; i < 256; i++)
+				{
+					if (ItsWordSplitter::IsWordCharacter(static_cast<char>(i)))
+					{
+						s.Add(static_cast<unsigned char>(i));
+					}
+				}
+				break;
+			case 's':
+			case 'S':
+				for (char w : string(" \t\n\r\f\v"))
+				{
+					s.Add(static_cast<unsigned char>(w));
+				}
+				break;
+			default:
+				return false;
+			}
+			if (c == 'D' || c == 'W' || c == 'S')
+			{
+				s.Invert();
+			}
+			for (int i = 0; i < 4; i++)
+			{
+				set.Bits[i] |= s.Bits[i];
+			}
+			return true;
+		}
+
+		static int HexValue(char c)
+		{
+			if (c >= '0' && c <= '9')
+			{
+				return c - '0';
+			}
+			if (c >= 'a' && c <= 'f')
+			{
+				return c - 'a' + 10;
+			}
+			if (c >= 'A' && c <= 'F')
+			{
+				return c - 'A' + 10;
+			}
+			return -1;
+		}
+
+		//
+		// (i): Parses the escape following '\'. A class escape is added to set and
+		//      literal set to -1, otherwise literal is the escaped byte.
+		//
+		bool ParseEscape(ByteSet& set, int& literal, bool inClass)
+		{
+			if (this->m_pos >= this->m_parse.size())
+			{
+				return this->Fail("trailing '\\'");
+			}
+			char c = this->m_parse[this->m_pos++];
+			literal = -1;
+			if (ItsPattern::AddEscapeClass(c, set))
+			{
+				return true;
+			}
+			switch (c)
+			{
+			case 't':
+				literal = '\t';
+				return true;
+			case 'n':
+				literal = '\n';
+				return true;
+			case 'r':
+				literal = '\r';
+				return true;
+			case 'f':
+				literal = '\f';
+				return true;
+			case 'v':
+				literal = '\v';
+				return true;
+			case '0':
+				literal = '\0';
+				return true;
+			case 'b':
+				if (inClass)
+				{
+					literal = '\b';
+					return true;
+				}
+				return this->Fail("word boundary not supported");
+			case 'B':
+				return this->Fail("word boundary not supported");
+			case 'x':
+				if (this->m_pos + 1 < this->m_parse.size() && ItsPattern::HexValue(this->m_parse[this->m_pos]) >= 0 && ItsPattern::HexValue(this->m_parse[this->m_pos + 1]) >= 0)
+				{
+					literal = ItsPattern::HexValue(this->m_parse[this->m_pos]) * 16 + ItsPattern::HexValue(this->m_parse[this->m_pos + 1]);
+					this->m_pos += 2;
+					return true;
+				}
+				return this->Fail("invalid '\\x' escape");
+			default:
+				if (c >= '1' && c <= '9')
+				{
+					return this->Fail("back-references not supported");
+				}
+				if (isalnum(static_cast<unsigned char>(c)))
+				{
+					return this->Fail("unsupported escape");
+				}
+				literal = static_cast<unsigned char>(c);
+				return true;
+			}
+		}
+
+		bool ParseClass(Fragment& fragment)
+		{
+			ByteSet set;
+			bool negate = false;
+			if (this->m_pos < this->m_parse.size() && this->m_parse[this->m_pos] == '^')
+			{
+				negate = true;
+				this->m_pos++;
+			}
+
+			// (i): As ECMAScript, a leading ']' closes the class: [] matches nothing, [^] any byte.
+			for (;;)
+			{
+				if (this->m_pos >= this->m_parse.size())
+				{
+					return this->Fail("missing ']'");
+				}
+				char c = this->m_parse[this->m_pos++];
+				if (c == ']')
+				{
+					break;
+				}
+
+				int low = static_cast<unsigned char>(c);
+				if (c == '\\')
+				{
+					if (!this->ParseEscape(set, low, true))
+					{
+						return false;
+					}
+					if (low < 0)
+					{
+						continue;
+					}
+				}
+
+				int high = low;
+				if (this->m_pos + 1 < this->m_parse.size() && this->m_parse[this->m_pos] == '-' && this->m_parse[this->m_pos + 1] != ']')
+				{
+					this->m_pos++;
+					char h = this->m_parse[this->m_pos++];
+					high = static_cast<unsigned char>(h);
+					if (h == '\\')
+					{
+						ByteSet ignore;
+						if (!this->ParseEscape(ignore, high, true))
+						{
+							return false;
+						}
+					}
+					if (high < low)
+					{
+						return this->Fail("invalid range");
+					}
+				}
+				for (int i = low; i <= high; i++)
+				{
+					set.Add(static_cast<unsigned char>(i));
+				}
+			}
+
+			this->FoldCase(set);
+			if (negate)
+			{
+				set.Invert();
+			}
+			fragment = this->SetFragment(set);
+			return true;
+		}
+
+		bool ParseAtom(Fragment& fragment)
+		{
+			char c = this->m_parse[this->m_pos++];
+			ByteSet set;
+			switch (c)
+			{
+			case '(':
+			{
+				if (this->m_parse.substr(this->m_pos, 2) == "?:")
+				{
+					this->m_pos += 2;
+				}
+				else if (this->m_parse.substr(this->m_pos, 2) == "?=" || this->m_parse.substr(this->m_pos, 2) == "?!")
+				{
+					return this->Fail("lookahead not supported");
+				}
+				else if (this->m_parse.substr(this->m_pos, 1) == "?")
+				{
+					return this->Fail("invalid group");
+				}
+				if (!this->ParseAlternation(fragment))
+				{
+					return false;
+				}
+				if (this->m_pos >= this->m_parse.size() || this->m_parse[this->m_pos] != ')')
+				{
+					return this->Fail("missing ')'");
+				}
+				this->m_pos++;
+				return true;
+			}
+			case '[':
+				return this->ParseClass(fragment);
+			case '.':
+				for (int i = 0; i < 256; i++)
+				{
+					if (i != '\n' && i != '\r')
+					{
+						set.Add(static_cast<unsigned char>(i));
+					}
+				}
+				fragment = this->SetFragment(set);
+				return true;
+			case '^':
+			{
+				int n = this->AddNode(Op::Begin);
+				fragment = Fragment{ n, { { n, 0 } } };
+				return true;
+			}
+			case '$':
+			{
+				int n = this->AddNode(Op::End);
+				fragment = Fragment{ n, { { n, 0 } } };
+				return true;
+			}
+			case '*':
+			case '+':
+			case '?':
+			case '{':
+				return this->Fail("nothing to repeat");
+			case '\\':
+			{
+				int literal = -1;
+				if (!this->ParseEscape(set, literal, false))
+				{
+					return false;
+				}
+				if (literal >= 0)
+				{
+					set.Add(static_cast<unsigned char>(literal));
+					this->FoldCase(set);
+				}
+				fragment = this->SetFragment(set);
+				return true;
+			}
+			default:
+				set.Add(static_cast<unsigned char>(c));
+				this->FoldCase(set);
+				fragment = this->SetFragment(set);
+				return true;
+			}
+		}
+
+		//
+		// (i): Copies fragment, whose nodes are first..last-1. The nodes of a repeated
+		//      atom are contiguous and its unpatched outs are -1, so the copy is an offset.
+		//
+		Fragment Clone(const Fragment& fragment, size_t first, size_t last)
+		{
+			int offset = static_cast<int>(this->m_nodes.size() - first);
+			for (size_t i = first; i < last; i++)
+			{
+				Node node = this->m_nodes[i];
+				node.Out = (node.Out >= 0) ? node.Out + offset : -1;
+				node.Out1 = (node.Out1 >= 0) ? node.Out1 + offset : -1;
+				this->m_nodes.push_back(node);
+			}
+			Fragment copy{ fragment.Start + offset, fragment.Outs };
+			for (auto& o : copy.Outs)
+			{
+				o.first += offset;
+			}
+			return copy;
+		}
+
+		void Append(Fragment& fragment, Fragment&& next)
+		{
+			this->Patch(fragment.Outs, next.Start);
+			fragment.Outs = std::move(next.Outs);
+		}
+
+		// (i): Parses {m}, {m,} or {m,n} at m_pos. max is -1 when unbounded.
+		bool ParseBounds(int& min, int& max)
+		{
+			auto number = [this](int& value) -> bool {
+				size_t start = this->m_pos;
+				value = 0;
+				while (this->m_pos < this->m_parse.size() && isdigit(static_cast<unsigned char>(this->m_parse[this->m_pos])))
+				{
+					value = value * 10 + (this->m_parse[this->m_pos++] - '0');
+					if (value > UINT16_MAX)
+					{
+						return false;
+					}
+				}
+				return this->m_pos > start;
+			};
+
+			this->m_pos++;
+			if (!number(min))
+			{
+				return this->Fail("invalid '{}' range");
+			}
+			max = min;
+			if (this->m_pos < this->m_parse.size() && this->m_parse[this->m_pos] == ',')
+			{
+				this->m_pos++;
+				max = -1;
+				if (this->m_pos < this->m_parse.size() && this->m_parse[this->m_pos] != '}' && !number(max))
+				{
+					return this->Fail("invalid '{}' range");
+				}
+			}
+			if (this->m_pos >= this->m_parse.size() || this->m_parse[this->m_pos] != '}' || (max >= 0 && max < min))
+			{
+				return this->Fail("invalid '{}' range");
+			}
+			this->m_pos++;
+			return true;
+		}
+
+		bool ParseRepeat(Fragment& fragment)
+		{
+			size_t first = this->m_nodes.size();
+			if (!this->ParseAtom(fragment))
+			{
+				return false;
+			}
+
+			while (this->m_pos < this->m_parse.size())
+			{
+				char q = this->m_parse[this->m_pos];
+				if (q == '{')
+				{
+					int min = 0;
+					int max = 0;
+					if (!this->ParseBounds(min, max))
+					{
+						return false;
+					}
+
+					// (i): x{m,n} is m copies of x followed by n-m optional copies, x{m,} ends
+					//      with x*. All copies are cloned before any of them is patched.
+					size_t last = this->m_nodes.size();
+					int count = (max < 0) ? min + 1 : max;
+					vector<Fragment> copies;
+					if (count > 0)
+					{
+						copies.push_back(fragment);
+					}
+					for (int i = 1; i < count; i++)
+					{
+						if (this->m_nodes.size() > ItsPattern::MaxNodes)
+						{
+							return this->Fail("pattern too large");
+						}
+						copies.push_back(this->Clone(fragment, first, last));
+					}
+
+					int n = this->AddNode(Op::Jump);
+					fragment = Fragment{ n, { { n, 0 } } };
+					for (int i = 0; i < count; i++)
+					{
+						Fragment& copy = copies[i];
+						if (i >= min)
+						{
+							int split = this->AddNode(Op::Split, copy.Start, -1);
+							if (max < 0)
+							{
+								this->Patch(copy.Outs, split);
+								copy = Fragment{ split, { { split, 1 } } };
+							}
+							else
+							{
+								copy.Start = split;
+								copy.Outs.push_back({ split, 1 });
+							}
+						}
+						this->Append(fragment, std::move(copy));
+					}
+				}
+				else if (q == '*' || q == '+' || q == '?')
+				{
+					this->m_pos++;
+					int split = this->AddNode(Op::Split, fragment.Start, -1);
+					if (q == '*')
+					{
+						this->Patch(fragment.Outs, split);
+						fragment = Fragment{ split, { { split, 1 } } };
+					}
+					else if (q == '+')
+					{
+						this->Patch(fragment.Outs, split);
+						fragment = Fragment{ fragment.Start, { { split, 1 } } };
+					}
+					else
+					{
+						fragment.Start = split;
+						fragment.Outs.push_back({ split, 1 });
+					}
+				}
+				else
+				{
+					break;
+				}
+
+				// (i): Lazy quantifiers accept the same texts, only the match length differs.
+				if (this->m_pos < this->m_parse.size() && this->m_parse[this->m_pos] == '?')
+				{
+					this->m_pos++;
+				}
+			}
+			return true;
+		}
+
+		bool ParseConcatenation(Fragment& fragment)
+		{
+			bool empty = true;
+			while (this->m_pos < this->m_parse.size() && this->m_parse[this->m_pos] != '|' && this->m_parse[this->m_pos] != ')')
+			{
+				Fragment next;
+				if (!this->ParseRepeat(next))
+				{
+					return false;
+				}
+				if (empty)
+				{
+					fragment = std::move(next);
+					empty = false;
+				}
+				else
+				{
+					this->Patch(fragment.Outs, next.Start);
+					fragment.Outs = std::move(next.Outs);
+				}
+				if (this->m_nodes.size() > ItsPattern::MaxNodes)
+				{
+					return this->Fail("pattern too large");
+				}
+			}
+			if (empty)
+			{
+				int n = this->AddNode(Op::Jump);
+				fragment = Fragment{ n, { { n, 0 } } };
+			}
+			return true;
+		}
+
+		bool ParseAlternation(Fragment& fragment)
+		{
+			if (!this->ParseConcatenation(fragment))
+			{
+				return false;
+			}
+			while (this->m_pos < this->m_parse.size() && this->m_parse[this->m_pos] == '|')
+			{
+				this->m_pos++;
+				Fragment right;
+				if (!this->ParseConcatenation(right))
+				{
+					return false;
+				}
+				int split = this->AddNode(Op::Split, fragment.Start, right.Start);
+				fragment.Start = split;
+				fragment.Outs.insert(fragment.Outs.end(), right.Outs.begin(), right.Outs.end());
+			}
+			return true;
+		}
+
+		struct Scratch
+		{
+			vector<int> Current;
+			vector<int> Next;
+			vector<int> Stack;
+			vector<uint32_t> Mark;
+			uint32_t Generation = 0;
+		};
+
+		static Scratch& GetScratch()
+		{
+			static thread_local Scratch scratch;
+			return scratch;
+		}
+
+		//
+		// (i): Adds the epsilon closure of node to list. Returns true if Match is reached.
+		//
+		bool AddState(Scratch& scratch, vector<int>& list, int node, bool atBegin, bool atEnd, bool keepEnd = false) const
+		{
+			bool match = false;
+			scratch.Stack.push_back(node);
+			while (!scratch.Stack.empty())
+			{
+				int n = scratch.Stack.back();
+				scratch.Stack.pop_back();
+				if (scratch.Mark[n] == scratch.Generation)
+				{
+					continue;
+				}
+				scratch.Mark[n] = scratch.Generation;
+
+				const Node& s = this->m_nodes[n];
+				switch (s.Code)
+				{
+				case Op::Split:
+					scratch.Stack.push_back(s.Out1);
+					scratch.Stack.push_back(s.Out);
+					break;
+				case Op::Jump:
+					scratch.Stack.push_back(s.Out);
+					break;
+				case Op::Begin:
+					if (atBegin)
+					{
+						scratch.Stack.push_back(s.Out);
+					}
+					break;
+				case Op::End:
+					if (atEnd)
+					{
+						scratch.Stack.push_back(s.Out);
+					}
+					else if (keepEnd)
+					{
+						list.push_back(n);
+					}
+					break;
+				case Op::Match:
+					match = true;
+					break;
+				case Op::Set:
+					list.push_back(n);
+					break;
+				}
+			}
+			return match;
+		}
+
+		void NextGeneration(Scratch& scratch) const
+		{
+			if (scratch.Mark.size() < this->m_nodes.size())
+			{
+				scratch.Mark.resize(this->m_nodes.size(), 0);
+			}
+			if (++scratch.Generation == 0)
+			{
+				std::fill(scratch.Mark.begin(), scratch.Mark.end(), 0);
+				scratch.Generation = 1;
+			}
+		}
+
+		//
+		// (i): Subset construction. A DFA state is the sorted set of Set and End nodes
+		//      reached; End nodes are only followed when the text ends.
+		//
+		bool BuildDfa(Dfa& dfa, bool search)
+		{
+			Scratch& scratch = ItsPattern::GetScratch();
+			std::map<vector<int>, int32_t> ids;
+			vector<vector<int>> states;
+
+			auto addState = [&](vector<int>& set, bool match) -> int32_t {
+				std::sort(set.begin(), set.end());
+				set.erase(std::unique(set.begin(), set.end()), set.end());
+				if (match)
+				{
+					// (i): -1 marks an accepting set, it is part of the state's identity.
+					set.insert(set.begin(), -1);
+				}
+				auto it = ids.find(set);
+				if (it != ids.end())
+				{
+					return it->second;
+				}
+				int32_t id = static_cast<int32_t>(states.size());
+				ids.emplace(set, id);
+				states.push_back(set);
+
+				uint8_t flags = match ? (AcceptNow | AcceptAtEnd) : 0;
+				if (!match)
+				{
+					vector<int> ignore;
+					this->NextGeneration(scratch);
+					for (int n : set)
+					{
+						if (n >= 0 && this->m_nodes[n].Code == Op::End && this->AddState(scratch, ignore, this->m_nodes[n].Out, false, true))
+						{
+							flags |= AcceptAtEnd;
+							break;
+						}
+					}
+				}
+				dfa.Flags.push_back(flags);
+				return id;
+			};
+
+			vector<int> set;
+			this->NextGeneration(scratch);
+			bool match = this->AddState(scratch, set, this->m_start, true, false, true);
+			dfa.Start = addState(set, match);
+
+			for (size_t i = 0; i < states.size(); i++)
+			{
+				if (states.size() > ItsPattern::MaxDfaStates)
+				{
+					dfa = Dfa();
+					return false;
+				}
+
+				dfa.Next.resize((i + 1) * 256);
+				const vector<int> current = states[i];
+				for (int c = 0; c < 256; c++)
+				{
+					vector<int> next;
+					this->NextGeneration(scratch);
+					match = false;
+					for (int n : current)
+					{
+						if (n < 0)
+						{
+							continue;
+						}
+						const Node& node = this->m_nodes[n];
+						if (node.Code == Op::Set && this->m_sets[node.SetIndex].Contains(static_cast<unsigned char>(c)))
+						{
+							match |= this->AddState(scratch, next, node.Out, false, false, true);
+						}
+					}
+					if (search)
+					{
+						match |= this->AddState(scratch, next, this->m_start, false, false, true);
+					}
+					dfa.Next[i * 256 + c] = addState(next, match);
+				}
+			}
+			return true;
+		}
+
+		bool RunDfa(const Dfa& dfa, std::string_view text, bool search) const
+		{
+			const int32_t* next = dfa.Next.data();
+			const uint8_t* flags = dfa.Flags.data();
+			int32_t state = dfa.Start;
+			if (search)
+			{
+				for (char c : text)
+				{
+					if (flags[state] & AcceptNow)
+					{
+						return true;
+					}
+					state = next[state * 256 + static_cast<unsigned char>(c)];
+				}
+			}
+			else
+			{
+				for (char c : text)
+				{
+					state = next[state * 256 + static_cast<unsigned char>(c)];
+				}
+			}
+			return (flags[state] & AcceptAtEnd) != 0;
+		}
+
+		bool Run(std::string_view text, bool search) const
+		{
+			if (!this->IsValid())
+			{
+				return false;
+			}
+
+			Scratch& scratch = ItsPattern::GetScratch();
+			const size_t n = text.size();
+			scratch.Current.clear();
+
+			this->NextGeneration(scratch);
+			bool matched = this->AddState(scratch, scratch.Current, this->m_start, true, n == 0);
+			if (matched && (search || n == 0))
+			{
+				return true;
+			}
+
+			for (size_t i = 0; i < n; i++)
+			{
+				if (!search && scratch.Current.empty())
+				{
+					return false;
+				}
+
+				unsigned char c = static_cast<unsigned char>(text[i]);
+				bool atEnd = (i + 1 == n);
+				scratch.Next.clear();
+				this->NextGeneration(scratch);
+				matched = false;
+				for (int s : scratch.Current)
+				{
+					const Node& node = this->m_nodes[s];
+					if (this->m_sets[node.SetIndex].Contains(c))
+					{
+						matched |= this->AddState(scratch, scratch.Next, node.Out, false, atEnd);
+					}
+				}
+				if (search)
+				{
+					matched |= this->AddState(scratch, scratch.Next, this->m_start, false, atEnd);
+					if (matched)
+					{
+						return true;
+					}
+				}
+				scratch.Current.swap(scratch.Next);
+			}
+
+			return matched;
+		}
+
+	public:
+		ItsPattern()
+			: m_start(-1), m_ignoreCase(false), m_literal(false), m_pos(0)
+		{
+		}
+
+		explicit ItsPattern(std::string_view expression, bool ignoreCase = false)
+			: m_start(-1), m_ignoreCase(ignoreCase), m_literal(false), m_expression(expression), m_pos(0)
+		{
+			this->m_literal = !ignoreCase && (expression.find_first_of("\\^$.|?*+()[{") == std::string_view::npos);
+
+			this->m_parse = this->m_expression;
+			Fragment fragment;
+			if (this->ParseAlternation(fragment))
+			{
+				if (this->m_pos < this->m_parse.size())
+				{
+					this->Fail("unmatched ')'");
+				}
+				else
+				{
+					int match = this->AddNode(Op::Match);
+					this->Patch(fragment.Outs, match);
+					this->m_start = fragment.Start;
+				}
+			}
+			this->m_parse = std::string_view();
+
+			if (this->m_error.size() == 0 && !this->m_literal)
+			{
+				this->BuildDfa(this->m_searchDfa, true);
+				this->BuildDfa(this->m_matchDfa, false);
+			}
+
+			if (this->m_error.size() > 0)
+			{
+				this->m_nodes.clear();
+				this->m_sets.clear();
+				this->m_start = -1;
+				this->m_literal = false;
+			}
+		}
+
+		bool IsValid() const
+		{
+			return this->m_start >= 0;
+		}
+
+		const string& GetError() const
+		{
+			return this->m_error;
+		}
+
+		const string& GetExpression() const
+		{
+			return this->m_expression;
+		}
+
+		//
+		// Method: Search
+		//
+		// (i): True if the pattern matches anywhere in text, as std::regex_search.
+		//
+		bool Search(std::string_view text) const
+		{
+			if (this->m_literal)
+			{
+				return ItsStringSearch::Find(text, this->m_expression) != ItsStringSearch::npos;
+			}
+			if (this->m_searchDfa.Start >= 0 && text.size() > 0)
+			{
+				return this->RunDfa(this->m_searchDfa, text, true);
+			}
+			return this->Run(text, true);
+		}
+
+		//
+		// Method: Match
+		//
+		// (i): True if the pattern matches all of text, as std::regex_match.
+		//
+		bool Match(std::string_view text) const
+		{
+			if (this->m_literal)
+			{
+				return text == this->m_expression;
+			}
+			if (this->m_matchDfa.Start >= 0 && text.size() > 0)
+			{
+				return this->RunDfa(this->m_matchDfa, text, false);
+			}
+			return this->Run(text, false);
+		}
+	};
+
+	//
+	// struct: ItsRegexCache
+	//
+	// (i): Compiled std::regex and ItsPattern objects keyed by expression. Lookups hit a
+	//      per-thread map first and only take the shared lock on a miss. Clear drops the
+	//      shared map and, lazily, every thread's map.
+	//      Both are bounded, since expressions may come from configuration or input:
+	//      the shared map keeps the MaxShared most recently used entries per type (LRU),
+	//      a thread's map is emptied when it reaches MaxPerThread entries. Evicted
+	//      objects live on while a caller holds the returned shared_ptr.
+	//
+	struct ItsRegexCache
+	{
+	public:
+		static constexpr size_t MaxShared = 1024;
+		static constexpr size_t MaxPerThread = 64;
+
+	private:
+		template <typename T>
+		struct Store
+		{
+			std::mutex Lock;
+			std::list<string> Order;  // most recently used first
+			std::unordered_map<string, std::pair<std::shared_ptr<const T>, std::list<string>::iterator>> Items;
+			std::atomic<uint64_t> Generation{ 0 };
+
+			// (i): Lock must be held.
+			std::shared_ptr<const T> Find(const string& key)
+			{
+				auto it = this->Items.find(key);
+				if (it == this->Items.end())
+				{
+					return nullptr;
+				}
+				this->Order.splice(this->Order.begin(), this->Order, it->second.second);
+				return it->second.first;
+			}
+
+			// (i): Lock must be held. Evicts the least recently used entry when full.
+			void Insert(const string& key, const std::shared_ptr<const T>& item)
+			{
+				this->Order.push_front(key);
+				this->Items.emplace(key, std::make_pair(item, this->Order.begin()));
+				if (this->Items.size() > ItsRegexCache::MaxShared)
+				{
+					this->Items.erase(this->Order.back());
+					this->Order.pop_back();
+				}
+			}
+
+			size_t Size()
+			{
+				std::lock_guard<std::mutex> lock(this->Lock);
+				return this->Items.size();
+			}
+		};
+
+		template <typename T>
+		struct ThreadStore
+		{
+			std::unordered_map<string, std::shared_ptr<const T>> Items;
+			uint64_t Generation = 0;
+		};
+
+		template <typename T>
+		static Store<T>& GetStore()
+		{
+			static Store<T> store;
+			return store;
+		}
+
+		template <typename T, typename Factory>
+		static std::shared_ptr<const T> Get(const string& key, Factory factory)
+		{
+			static thread_local ThreadStore<T> local;
+			Store<T>& store = ItsRegexCache::GetStore<T>();
+
+			uint64_t generation = store.Generation.load(std::memory_order_acquire);
+			if (local.Generation != generation)
+			{
+				local.Items.clear();
+				local.Generation = generation;
+			}
+
+			auto it = local.Items.find(key);
+			if (it != local.Items.end())
+			{
+				return it->second;
+			}
+
+			std::shared_ptr<const T> item;
+			{
+				std::lock_guard<std::mutex> lock(store.Lock);
+				item = store.Find(key);
+			}
+			if (!item)
+			{
+				item = factory();
+				std::lock_guard<std::mutex> lock(store.Lock);
+				auto existing = store.Find(key);
+				if (existing)
+				{
+					item = existing;
+				}
+				else
+				{
+					store.Insert(key, item);
+				}
+			}
+
+			if (local.Items.size() >= ItsRegexCache::MaxPerThread)
+			{
+				local.Items.clear();
+			}
+			local.Items.emplace(key, item);
+			return item;
+		}
+
+	public:
+		//
+		// Function: GetRegex
+		//
+		// (i): Cached std::regex. Throws std::regex_error for an invalid expression, as
+		//      the std::regex constructor.
+		//
+		static std::shared_ptr<const std::regex> GetRegex(const string& expression, std::regex::flag_type flags = std::regex::ECMAScript)
+		{
+			string key = expression;
+			key.push_back('\0');
+			key += std::to_string(static_cast<unsigned>(flags));
+			return ItsRegexCache::Get<std::regex>(key, [&]() {
+				return std::make_shared<const std::regex>(expression, flags);
+			});
+		}
+
+		//
+		// Function: GetPattern
+		//
+		// (i): Cached ItsPattern. Check IsValid on the result.
+		//
+		static std::shared_ptr<const ItsPattern> GetPattern(const string& expression, bool ignoreCase = false)
+		{
+			string key = expression;
+			key.push_back(ignoreCase ? 'i' : '\0');
+			return ItsRegexCache::Get<ItsPattern>(key, [&]() {
+				return std::make_shared<const ItsPattern>(expression, ignoreCase);
+			});
+		}
+
+		static void Clear()
+		{
+			ItsRegexCache::ClearStore<std::regex>();
+			ItsRegexCache::ClearStore<ItsPattern>();
+		}
+
+		// Entries in the shared maps, at most 2 * MaxShared.
+		static size_t GetSize()
+		{
+			return ItsRegexCache::GetStore<std::regex>().Size() + ItsRegexCache::GetStore<ItsPattern>().Size();
+		}
+
+	private:
+		template <typename T>
+		static void ClearStore()
+		{
+			Store<T>& store = ItsRegexCache::GetStore<T>();
+			std::lock_guard<std::mutex> lock(store.Lock);
+			store.Items.clear();
+			store.Order.clear();
+			store.Generation.fetch_add(1, std::memory_order_release);
+		}
+	};
+
+	//
+	// enum: DataSizeStringType
+	//
+	// (i): Enum for string representation of ToDataSizeString ItsConvert function.
+	//
+	enum class ItsDataSizeStringType
+	{
+		Recommended,
+		IEC
+	};
+
+	//
+	// struct: ItsDigits
+	//
+	// (i): Digit pair lookup table for allocation free number formatting.
+	//
+	struct ItsDigits
+	{
+		static constexpr char Pairs[201] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+		// (i): Writes value % 100 as two digits.
+		static char* Write2(char* p, unsigned value)
+		{
+			memcpy(p, &ItsDigits::Pairs[(value % 100) * 2], 2);
+			return p + 2;
+		}
+
+		// (i): Writes value % 10000 as four digits.
+		static char* Write4(char* p, unsigned value)
+		{
+			value %= 10000;
+			ItsDigits::Write2(p, value / 100);
+			return ItsDigits::Write2(p + 2, value % 100);
+		}
+
+		// (i): Parses count digits. Returns false on a non digit.
+		static constexpr bool Parse(const char* p, size_t count, int* value)
+		{
+			int v = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				unsigned d = static_cast<unsigned>(p[i] - '0');
+				if (d > 9)
+				{
+					return false;
+				}
+				v = v * 10 + static_cast<int>(d);
+			}
+			*value = v;
+			return true;
+		}
+	};
+
+	//
+	// struct: ItsHexNibbleTable
+	//
+	// (i): Hex digit values for ItsHex, -1 for other characters.
+	//
+	struct ItsHexNibbleTable
+	{
+		int8_t Values[256];
+
+		constexpr ItsHexNibbleTable()
+			: Values()
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				this->Values[i] = -1;
+			}
+			for (int i = 0; i < 10; i++)
+			{
+				this->Values['0' + i] = static_cast<int8_t>(i);
+			}
+			for (int i = 0; i < 6; i++)
+			{
+				this->Values['a' + i] = static_cast<int8_t>(10 + i);
+				this->Values['A' + i] = static_cast<int8_t>(10 + i);
+			}
+		}
+	};
+
+	//
+	// struct: ItsHex
+	//
+	// (i): Table driven hex codec for byte spans and integers. Encoding runs 16 bytes per
+	//      step with SSE2 when available.
+	//
+	struct ItsHex
+	{
+	private:
+		static constexpr ItsHexNibbleTable Nibbles{};
+
+	public:
+		static constexpr char UpperDigits[17] = "0123456789ABCDEF";
+		static constexpr char LowerDigits[17] = "0123456789abcdef";
+
+		// (i): Value of hex digit c, -1 if c is not one.
+		static constexpr int DecodeNibble(char c)
+		{
+			return ItsHex::Nibbles.Values[static_cast<unsigned char>(c)];
+		}
+
+		// (i): Writes the low digits hex digits of value, most significant first.
+		template <typename Unsigned>
+		static char* Write(char* p, Unsigned value, size_t digits, bool uppercase = true)
+		{
+			const char* table = uppercase ? ItsHex::UpperDigits : ItsHex::LowerDigits;
+			for (size_t i = digits; i > 0; i--)
+			{
+				p[i - 1] = table[value & 0xF];
+				value >>= 4;
+			}
+			return p + digits;
+		}
+
+		// (i): Writes value with the fewest digits, at least one.
+		template <typename Unsigned>
+		static char* WriteMinimal(char* p, Unsigned value, bool uppercase = true)
+		{
+			size_t digits = 1;
+			for (Unsigned v = value >> 4; v != 0; v >>= 4)
+			{
+				digits++;
+			}
+			return ItsHex::Write(p, value, digits, uppercase);
+		}
+
+		//
+		// Function: Encode
+		//
+		// (i): Writes size * 2 hex digits for data into out, not zero terminated.
+		//
+		static size_t Encode(const void* data, size_t size, char* out, bool uppercase = false)
+		{
+			const uint8_t* in = static_cast<const uint8_t*>(data);
+			size_t i = 0;
+#ifdef ITS_SIMD_SSE2
+			const __m128i mask = _mm_set1_epi8(0x0F);
+			const __m128i nine = _mm_set1_epi8(9);
+			const __m128i zero = _mm_set1_epi8('0');
+			const __m128i letter = _mm_set1_epi8(uppercase ? ('A' - '0' - 10) : ('a' - '0' - 10));
+			for (; i + 16 <= size; i += 16)
+			{
+				__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+				__m128i lo = _mm_and_si128(x, mask);
+				__m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+				lo = _mm_add_epi8(_mm_add_epi8(lo, zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), letter));
+				hi = _mm_add_epi8(_mm_add_epi8(hi, zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), letter));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2), _mm_unpacklo_epi8(hi, lo));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+			}
+#endif
+			const char* table = uppercase ? ItsHex::UpperDigits : ItsHex::LowerDigits;
+			for (; i < size; i++)
+			{
+				out[i * 2] = table[in[i] >> 4];
+				out[i * 2 + 1] = table[in[i] & 0xF];
+			}
+			return size * 2;
+		}
+
+		static string Encode(const void* data, size_t size, bool uppercase = false)
+		{
+			string result(size * 2, '\0');
+			ItsHex::Encode(data, size, result.data(), uppercase);
+			return result;
+		}
+
+		//
+		// Function: Decode
+		//
+		// (i): Decodes exactly outSize * 2 hex digits into out. False on any other length
+		//      or a non hex character.
+		//
+		static bool Decode(std::string_view hex, void* out, size_t outSize)
+		{
+			if (hex.size() != outSize * 2)
+			{
+				return false;
+			}
+
+			uint8_t* o = static_cast<uint8_t*>(out);
+			int bad = 0;
+			for (size_t i = 0; i < outSize; i++)
+			{
+				int hi = ItsHex::DecodeNibble(hex[i * 2]);
+				int lo = ItsHex::DecodeNibble(hex[i * 2 + 1]);
+				bad |= hi | lo;
+				o[i] = static_cast<uint8_t>((hi << 4) | (lo & 0xF));
+			}
+			return bad >= 0;
+		}
+
+		static bool Decode(std::string_view hex, vector<uint8_t>& out)
+		{
+			if (hex.size() % 2 != 0)
+			{
+				return false;
+			}
+			out.resize(hex.size() / 2);
+			return ItsHex::Decode(hex, out.data(), out.size());
+		}
+
+		//
+		// Function: TryParse
+		//
+		// (i): Parses 1..16 hex digits with an optional 0x prefix.
+		//
+		static bool TryParse(std::string_view hex, uint64_t* value)
+		{
+			if (hex.size() > 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X'))
+			{
+				hex.remove_prefix(2);
+			}
+			if (hex.size() == 0 || hex.size() > 16)
+			{
+				return false;
+			}
+
+			uint64_t v = 0;
+			for (char c : hex)
+			{
+				int n = ItsHex::DecodeNibble(c);
+				if (n < 0)
+				{
+					return false;
+				}
+				v = (v << 4) | static_cast<uint64_t>(n);
+			}
+			*value = v;
+			return true;
+		}
+	};
+
+	//
+	// struct: ItsConvert
+	//
+	// (i): Misc. convertion routines in one place.
+	//
+	struct ItsConvert
+	{
+		static string ToDataSizeString(size_t size)
+		{
+			return ItsConvert::ToDataSizeString(size, 0);
+		}
+		static string ToDataSizeString(size_t size, int digits)
+		{
+			return ItsConvert::ToDataSizeString(size, digits, ItsDataSizeStringType::Recommended);
+		}
+		static string ToDataSizeString(size_t size, int digits, ItsDataSizeStringType type)
+		{
+			char buffer[ItsConvert::DataSizeBufferSize];
+			size_t length = ItsConvert::ToDataSizeString(size, digits, type, buffer, sizeof(buffer));
+			return string(buffer, length);
+		}
+
+		//
+		// Function: ToDataSizeString
+		//
+		// (i): Allocation free, integer only variant writing e.g. "1.50 KB" into buffer, zero
+		//      terminated. digits (0..3) decimals are truncated, not rounded. Returns the
+		//      length, or 0 if the buffer is too small.
+		//
+		static constexpr size_t DataSizeBufferSize = 32;
+
+		static size_t ToDataSizeString(size_t size, int digits, ItsDataSizeStringType type, char* buffer, size_t bufferSize)
+		{
+			static constexpr const char* RecommendedUnits[] = { "B", "KB", "MB", "GB", "TB", "PB", "EB" };
+			static constexpr const char* IecUnits[] = { "Bi", "KiB", "MiB", "GiB", "TiB", "PiB", "EiB" };
+			static constexpr unsigned Pow10[] = { 1, 10, 100, 1000 };
+
+			if (digits < 0)
+			{
+				digits = 0;
+			}
+			else if (digits > 3)
+			{
+				digits = 3;
+			}
+
+			unsigned index = 0;
+			while (index < 6 && (size >> (10 * (index + 1))) > 0)
+			{
+				index++;
+			}
+
+			uint64_t whole = static_cast<uint64_t>(size) >> (10 * index);
+			uint64_t remainder = static_cast<uint64_t>(size) & ((uint64_t(1) << (10 * index)) - 1);
+
+			char temp[ItsConvert::DataSizeBufferSize];
+			char* p = temp;
+			auto r = std::to_chars(p, temp + sizeof(temp), whole);
+			p = r.ptr;
+			if (digits > 0)
+			{
+				unsigned fraction = static_cast<unsigned>((static_cast<unsigned __int128>(remainder) * Pow10[digits]) >> (10 * index));
+				*p++ = '.';
+				for (int d = digits - 1; d >= 0; d--)
+				{
+					p[d] = static_cast<char>('0' + fraction % 10);
+					fraction /= 10;
+				}
+				p += digits;
+			}
+			*p++ = ' ';
+			const char* unit = (type == ItsDataSizeStringType::IEC) ? IecUnits[index] : RecommendedUnits[index];
+			size_t unitLength = strlen(unit);
+			memcpy(p, unit, unitLength);
+			p += unitLength;
+
+			size_t length = static_cast<size_t>(p - temp);
+			if (length + 1 > bufferSize)
+			{
+				return 0;
+			}
+			memcpy(buffer, temp, length);
+			buffer[length] = '\0';
+			return length;
+		}
+
+		//
+		// Function: ToDataSizeStringColumn
+		//
+		// (i): Batch variant. Writes count values right aligned into consecutive cells of
+		//      width chars in buffer (count * width chars, not zero terminated). Values
+		//      that do not fit a cell are filled with '#'. Returns the number of cells
+		//      written.
+		//
+		static size_t ToDataSizeStringColumn(const size_t* values, size_t count, int digits, ItsDataSizeStringType type, char* buffer, size_t bufferSize, size_t width)
+		{
+			char cell[ItsConvert::DataSizeBufferSize];
+			size_t written = 0;
+			for (; written < count && (written + 1) * width <= bufferSize; written++)
+			{
+				size_t length = ItsConvert::ToDataSizeString(values[written], digits, type, cell, sizeof(cell));
+				ItsConvert::WriteCell(buffer + written * width, width, cell, length);
+			}
+			return written;
+		}
+
+		template <typename Numeric>
+		static Numeric ToNumber(const string& str)
+		{
+			if constexpr (std::is_same_v<Numeric, char> || std::is_same_v<Numeric, signed char> || std::is_same_v<Numeric, unsigned char> ||
+						  std::is_same_v<Numeric, short> || std::is_same_v<Numeric, unsigned short>)
+			{
+				return static_cast<Numeric>(std::stoi(str));
+			}
+			else if constexpr (std::is_same_v<Numeric, float>)
+			{
+				return std::stof(str);
+			}
+			else if constexpr (std::is_same_v<Numeric, double>)
+			{
+				return std::stod(str);
+			}
+			else if constexpr (std::is_same_v<Numeric, long double>)
+			{
+				return std::stold(str);
+			}
+			else if constexpr (std::is_same_v<Numeric, int>)
+			{
+				return std::stoi(str);
+			}
+			else if constexpr (std::is_same_v<Numeric, long>)
+			{
+				return std::stol(str);
+			}
+			else if constexpr (std::is_same_v<Numeric, long long>)
+			{
+				return std::stoll(str);
+			}
+			else if constexpr (std::is_same_v<Numeric, unsigned int>)
+			{
+				return static_cast<unsigned int>(std::stoul(str));
+			}
+			else if constexpr (std::is_same_v<Numeric, unsigned long>)
+			{
+				return std::stoul(str);
+			}
+			else
+			{
+				return static_cast<Numeric>(std::stoull(str));
+			}
+		}
+
+		//
+		// Function: TryParse
+		//
+		// (i): Non-throwing, allocation free parse of all of text with std::from_chars.
+		//      A leading '+' is accepted, whitespace is not. False on syntax error,
+		//      trailing characters or overflow.
+		//
+		template <typename Numeric>
+		static bool TryParse(std::string_view text, Numeric* value)
+		{
+			static_assert(std::is_arithmetic_v<Numeric> && !std::is_same_v<Numeric, bool>, "TryParse requires a numeric type");
+
+			const char* first = text.data();
+			const char* last = text.data() + text.size();
+			if (first != last && *first == '+')
+			{
+				first++;
+				if (first != last && *first == '-')
+				{
+					return false;
+				}
+			}
+
+			Numeric result{};
+			std::from_chars_result r;
+			if constexpr (std::is_floating_point_v<Numeric>)
+			{
+				r = std::from_chars(first, last, result, std::chars_format::general);
+			}
+			else
+			{
+				r = std::from_chars(first, last, result, 10);
+			}
+			if (r.ec != std::errc() || r.ptr != last)
+			{
+				return false;
+			}
+
+			*value = result;
+			return true;
+		}
+
+		//
+		// Function: Format
+		//
+		// (i): Allocation free std::to_chars formatting into buffer, zero terminated.
+		//      Floating point uses the same digits10 precision as ToString. Returns
+		//      the length, or 0 if the buffer is too small.
+		//
+		static constexpr size_t NumberBufferSize = 64;
+
+		template <typename Numeric>
+		static size_t Format(Numeric value, char* buffer, size_t size)
+		{
+			static_assert(std::is_arithmetic_v<Numeric> && !std::is_same_v<Numeric, bool>, "Format requires a numeric type");
+
+			if (size == 0)
+			{
+				return 0;
+			}
+
+			std::to_chars_result r;
+			if constexpr (std::is_floating_point_v<Numeric>)
+			{
+				r = std::to_chars(buffer, buffer + size - 1, value, std::chars_format::general, std::numeric_limits<Numeric>::digits10);
+			}
+			else
+			{
+				r = std::to_chars(buffer, buffer + size - 1, value, 10);
+			}
+			if (r.ec != std::errc())
+			{
+				return 0;
+			}
+
+			*r.ptr = '\0';
+			return static_cast<size_t>(r.ptr - buffer);
+		}
+
+		//
+		// Function: ParseDelimited
+		//
+		// (i): Parses up to count delimiter separated numbers from text into values.
+		//      Spaces and tabs around fields are ignored. Stops at the first field that
+		//      does not parse and returns the number of values parsed.
+		//
+		template <typename Numeric>
+		static size_t ParseDelimited(std::string_view text, char delimiter, Numeric* values, size_t count)
+		{
+			size_t parsed = 0;
+			size_t pos = 0;
+			while (parsed < count && pos <= text.size())
+			{
+				const char* hit = static_cast<const char*>(memchr(text.data() + pos, delimiter, text.size() - pos));
+				size_t end = (hit != nullptr) ? static_cast<size_t>(hit - text.data()) : text.size();
+				if (!ItsConvert::TryParse(ItsString::TrimView(text.substr(pos, end - pos), " \t"), &values[parsed]))
+				{
+					break;
+				}
+				parsed++;
+				if (hit == nullptr)
+				{
+					break;
+				}
+				pos = end + 1;
+			}
+			return parsed;
+		}
+
+		//
+		// Function: TryParseDelimited
+		//
+		// (i): Parses every field of a delimiter separated line into values. False at the
+		//      first field that does not parse; values then holds the fields before it.
+		//
+		template <typename Numeric>
+		static bool TryParseDelimited(std::string_view text, char delimiter, vector<Numeric>& values)
+		{
+			values.clear();
+			size_t pos = 0;
+			for (;;)
+			{
+				const char* hit = static_cast<const char*>(memchr(text.data() + pos, delimiter, text.size() - pos));
+				size_t end = (hit != nullptr) ? static_cast<size_t>(hit - text.data()) : text.size();
+				Numeric value;
+				if (!ItsConvert::TryParse(ItsString::TrimView(text.substr(pos, end - pos), " \t"), &value))
+				{
+					return false;
+				}
+				values.push_back(value);
+				if (hit == nullptr)
+				{
+					return true;
+				}
+				pos = end + 1;
+			}
+		}
+
+		//
+		// Function: ParseColumn
+		//
+		// (i): Appends column (0 based) of every line of delimiter separated text to values.
+		//      Lines that are empty, too short or whose field does not parse are skipped.
+		//      Returns the number of values appended.
+		//
+		template <typename Numeric>
+		static size_t ParseColumn(std::string_view text, char delimiter, size_t column, vector<Numeric>& values)
+		{
+			size_t appended = 0;
+			for (auto line : ItsLineSplitter(text))
+			{
+				size_t pos = 0;
+				size_t index = 0;
+				while (index < column)
+				{
+					const char* hit = static_cast<const char*>(memchr(line.data() + pos, delimiter, line.size() - pos));
+					if (hit == nullptr)
+					{
+						break;
+					}
+					pos = static_cast<size_t>(hit - line.data()) + 1;
+					index++;
+				}
+				if (index != column)
+				{
+					continue;
+				}
+
+				const char* hit = static_cast<const char*>(memchr(line.data() + pos, delimiter, line.size() - pos));
+				size_t end = (hit != nullptr) ? static_cast<size_t>(hit - line.data()) : line.size();
+				Numeric value;
+				if (ItsConvert::TryParse(ItsString::TrimView(line.substr(pos, end - pos), " \t"), &value))
+				{
+					values.push_back(value);
+					appended++;
+				}
+			}
+			return appended;
+		}
+
+		//
+		// Function: ToLongFromHex
+		//
+		// (i): As strtol(str, 16) without the locale machinery: leading whitespace, a sign
+		//      and a 0x prefix are accepted, overflow saturates. 0 if anything follows the
+		//      digits.
+		//
+		static int ToLongFromHex(const string& str)
+		{
+			const char* p = str.c_str();
+			while (*p == ' ' || (*p >= '\t' && *p <= '\r'))
+			{
+				p++;
+			}
+			bool negative = false;
+			if (*p == '+' || *p == '-')
+			{
+				negative = (*p == '-');
+				p++;
+			}
+			if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X') && ItsHex::DecodeNibble(p[2]) >= 0)
+			{
+				p += 2;
+			}
+
+			const uint64_t limit = negative ? static_cast<uint64_t>(LONG_MAX) + 1 : static_cast<uint64_t>(LONG_MAX);
+			uint64_t value = 0;
+			bool overflow = false;
+			int n;
+			while ((n = ItsHex::DecodeNibble(*p)) >= 0)
+			{
+				if (value > (limit - static_cast<uint64_t>(n)) / 16)
+				{
+					overflow = true;
+				}
+				else
+				{
+					value = value * 16 + static_cast<uint64_t>(n);
+				}
+				p++;
+			}
+			if (*p != 0)
+			{
+				return 0;
+			}
+
+			long result;
+			if (overflow)
+			{
+				result = negative ? LONG_MIN : LONG_MAX;
+			}
+			else
+			{
+				result = negative ? static_cast<long>(0 - value) : static_cast<long>(value);
+			}
+			return static_cast<int>(result);
+		}
+
+		static string ToString(const bool flag)
+		{
+			if (flag)
+			{
+				return string("True");
+			}
+			return string("False");
+		}
+
+		template <typename Numeric>
+		static string ToString(Numeric number)
+		{
+			if constexpr (std::is_same_v<Numeric, char> || std::is_same_v<Numeric, signed char> || std::is_same_v<Numeric, unsigned char>)
+			{
+				// (i): Characters, as the stream inserter prints them.
+				return string(1, static_cast<char>(number));
+			}
+			else if constexpr (std::is_arithmetic_v<Numeric>)
+			{
+				char buffer[ItsConvert::NumberBufferSize];
+				size_t length = ItsConvert::Format(number, buffer, sizeof(buffer));
+				return string(buffer, length);
+			}
+			else
+			{
+				stringstream ss;
+				ss << number;
+
+				string tos = ss.str();
+				return tos;
+			}
+		}
+
+		static string ToStringFormatted(size_t number, char thousandSep = ',')
+		{
+			char buffer[ItsConvert::FormattedNumberBufferSize];
+			size_t length = ItsConvert::ToStringFormatted(number, buffer, sizeof(buffer), thousandSep);
+			return string(buffer, length);
+		}
+
+		//
+		// Function: ToStringFormatted
+		//
+		// (i): Allocation free variant writing number with thousand separators into buffer,
+		//      zero terminated. Three digits per step from a digit pair table. Returns the
+		//      length, or 0 if the buffer is too small.
+		//
+		static constexpr size_t FormattedNumberBufferSize = 32;
+
+		static size_t ToStringFormatted(uint64_t number, char* buffer, size_t size, char thousandSep = ',')
+		{
+			char temp[ItsConvert::FormattedNumberBufferSize];
+			char* end = temp + sizeof(temp);
+			char* p = end;
+			while (number >= 1000)
+			{
+				unsigned group = static_cast<unsigned>(number % 1000);
+				number /= 1000;
+				p -= 3;
+				p[0] = static_cast<char>('0' + group / 100);
+				ItsDigits::Write2(p + 1, group % 100);
+				*--p = thousandSep;
+			}
+			unsigned lead = static_cast<unsigned>(number);
+			if (lead >= 100)
+			{
+				p -= 3;
+				p[0] = static_cast<char>('0' + lead / 100);
+				ItsDigits::Write2(p + 1, lead % 100);
+			}
+			else if (lead >= 10)
+			{
+				p -= 2;
+				ItsDigits::Write2(p, lead);
+			}
+			else
+			{
+				*--p = static_cast<char>('0' + lead);
+			}
+
+			size_t length = static_cast<size_t>(end - p);
+			if (length + 1 > size)
+			{
+				return 0;
+			}
+			memcpy(buffer, p, length);
+			buffer[length] = '\0';
+			return length;
+		}
+
+		//
+		// Function: ToStringFormattedColumn
+		//
+		// (i): Batch variant, see ToDataSizeStringColumn for the cell layout.
+		//
+		static size_t ToStringFormattedColumn(const size_t* values, size_t count, char* buffer, size_t bufferSize, size_t width, char thousandSep = ',')
+		{
+			char cell[ItsConvert::FormattedNumberBufferSize];
+			size_t written = 0;
+			for (; written < count && (written + 1) * width <= bufferSize; written++)
+			{
+				size_t length = ItsConvert::ToStringFormatted(values[written], cell, sizeof(cell), thousandSep);
+				ItsConvert::WriteCell(buffer + written * width, width, cell, length);
+			}
+			return written;
+		}
+
+		//
+		// Function: WriteCell
+		//
+		// (i): Right aligns text in a cell of width chars, '#' filled if it does not fit.
+		//
+		static void WriteCell(char* cell, size_t width, const char* text, size_t length)
+		{
+			if (length > width)
+			{
+				memset(cell, '#', width);
+				return;
+			}
+			memset(cell, ' ', width - length);
+			memcpy(cell + width - length, text, length);
+		}
+
+		static string ToString(const tm &dateTime)
+		{
+			char buffer[ItsConvert::DateTimeBufferSize];
+			size_t length = ItsConvert::ToString(dateTime, 'T', buffer, sizeof(buffer));
+			return string(buffer, length);
+		}
+
+		//
+		// Function: ToString
+		//
+		// (i): Writes "yyyy-MM-dd<separator>HH:mm:ss" into buffer, zero terminated.
+		//      Returns the length, or 0 if the buffer is too small.
+		//
+		static constexpr size_t DateTimeBufferSize = 32;
+
+		static size_t ToString(const tm &dateTime, char separator, char* buffer, size_t size)
+		{
+			int year = dateTime.tm_year + 1900;
+			if (year < 0 || year > 9999)
+			{
+				int n = snprintf(buffer, size, "%04d-%02d-%02d%c%02d:%02d:%02d", year, dateTime.tm_mon + 1, dateTime.tm_mday,
+								 separator, dateTime.tm_hour, dateTime.tm_min, dateTime.tm_sec);
+				return (n > 0 && static_cast<size_t>(n) < size) ? static_cast<size_t>(n) : 0;
+			}
+
+			if (size < 20)
+			{
+				return 0;
+			}
+
+			char* p = buffer;
+			p = ItsDigits::Write4(p, static_cast<unsigned>(year));
+			*p++ = '-';
+			p = ItsDigits::Write2(p, static_cast<unsigned>(dateTime.tm_mon + 1));
+			*p++ = '-';
+			p = ItsDigits::Write2(p, static_cast<unsigned>(dateTime.tm_mday));
+			*p++ = separator;
+			p = ItsDigits::Write2(p, static_cast<unsigned>(dateTime.tm_hour));
+			*p++ = ':';
+			p = ItsDigits::Write2(p, static_cast<unsigned>(dateTime.tm_min));
+			*p++ = ':';
+			p = ItsDigits::Write2(p, static_cast<unsigned>(dateTime.tm_sec));
+			*p = '\0';
+			return 19;
+		}
+
+		//
+		// Function: TryParseDateTime
+		//
+		// (i): ISO-8601 parser. Accepts "yyyy-MM-dd", "yyyy-MM-ddTHH:mm[:ss[.fff]]" with 'T' or ' '
+		//      separator and an optional "Z" or "+hh[:mm]"/"-hh[:mm]" zone. The zone offset in
+		//      seconds is returned in utcOffset if given; fields are not adjusted by it.
+		//
+		static bool TryParseDateTime(std::string_view text, tm* dateTime, int* utcOffset = nullptr)
+		{
+			tm t{};
+			int offset = 0;
+			int year = 0, month = 0, day = 0;
+
+			if (text.size() < 10 ||
+				!ItsDigits::Parse(text.data(), 4, &year) || text[4] != '-' ||
+				!ItsDigits::Parse(text.data() + 5, 2, &month) || text[7] != '-' ||
+				!ItsDigits::Parse(text.data() + 8, 2, &day))
+			{
+				return false;
+			}
+			if (month < 1 || month > 12 || day < 1 || day > 31)
+			{
+				return false;
+			}
+			t.tm_year = year - 1900;
+			t.tm_mon = month - 1;
+			t.tm_mday = day;
+
+			size_t i = 10;
+			if (i < text.size() && (text[i] == 'T' || text[i] == 't' || text[i] == ' '))
+			{
+				int hour = 0, min = 0, sec = 0;
+				if (text.size() < i + 6 ||
+					!ItsDigits::Parse(text.data() + i + 1, 2, &hour) || text[i + 3] != ':' ||
+					!ItsDigits::Parse(text.data() + i + 4, 2, &min))
+				{
+					return false;
+				}
+				i += 6;
+				if (i < text.size() && text[i] == ':')
+				{
+					if (text.size() < i + 3 || !ItsDigits::Parse(text.data() + i + 1, 2, &sec))
+					{
+						return false;
+					}
+					i += 3;
+					if (i < text.size() && (text[i] == '.' || text[i] == ','))
+					{
+						i++;
+						size_t start = i;
+						while (i < text.size() && text[i] >= '0' && text[i] <= '9')
+						{
+							i++;
+						}
+						if (i == start)
+						{
+							return false;
+						}
+					}
+				}
+				if (hour > 24 || min > 59 || sec > 60)
+				{
+					return false;
+				}
+				t.tm_hour = hour;
+				t.tm_min = min;
+				t.tm_sec = sec;
+
+				if (i < text.size() && (text[i] == 'Z' || text[i] == 'z'))
+				{
+					i++;
+				}
+				else if (i < text.size() && (text[i] == '+' || text[i] == '-'))
+				{
+					int sign = (text[i] == '-') ? -1 : 1;
+					int oh = 0, om = 0;
+					if (text.size() < i + 3 || !ItsDigits::Parse(text.data() + i + 1, 2, &oh))
+					{
+						return false;
+					}
+					i += 3;
+					if (i < text.size() && text[i] == ':')
+					{
+						i++;
+					}
+					if (i + 2 <= text.size() && ItsDigits::Parse(text.data() + i, 2, &om))
+					{
+						i += 2;
+					}
+					offset = sign * (oh * 3600 + om * 60);
+				}
+			}
+
+			if (i != text.size())
+			{
+				return false;
+			}
+
+			*dateTime = t;
+			if (utcOffset != nullptr)
+			{
+				*utcOffset = offset;
+			}
+			return true;
+		}
+
+		template <typename Numeric>
+		static string ToHexString(Numeric number, bool uppercase = true, uint32_t width = 0, char fillChar = '0', bool showBase = false)
+		{
+			if constexpr (std::is_integral_v<Numeric> && !std::is_same_v<Numeric, bool> && !std::is_same_v<Numeric, char> &&
+						  !std::is_same_v<Numeric, signed char> && !std::is_same_v<Numeric, unsigned char>)
+			{
+				// (i): Two's complement digits of the value, as the stream inserter.
+				char digits[2 * sizeof(Numeric)];
+				char* end = ItsHex::WriteMinimal(digits, static_cast<std::make_unsigned_t<Numeric>>(number), uppercase);
+				size_t length = static_cast<size_t>(end - digits);
+
+				string tos;
+				tos.reserve((showBase ? 2 : 0) + std::max<size_t>(width, length));
+				if (showBase)
+				{
+					tos.append("0x");
+				}
+				if (width > length)
+				{
+					tos.append(width - length, fillChar);
+				}
+				tos.append(digits, length);
+				return tos;
+			}
+			else
+			{
+				stringstream ss;
+				ss << std::hex;
+				if (showBase)
+				{
+					ss << "0x";
+				}
+				if (uppercase)
+				{
+					ss << std::uppercase;
+				}
+				if (width > 0)
+				{
+					ss << std::setfill(fillChar) << std::setw(width);
+				}
+				ss << number;
+
+				string tos = ss.str();
+				return tos;
+			}
+		}
+
+		static tm ToTM(const string& dateTime)
+		{
+			tm t = {0};
+			if (ItsConvert::TryParseDateTime(dateTime, &t))
+			{
+				return t;
+			}
+
+			t.tm_year = ItsConvert::ToNumber<int>(dateTime.substr(0, 4)) - 1900;
+			t.tm_mon = ItsConvert::ToNumber<int>(dateTime.substr(5, 2)) - 1;
+			t.tm_mday = ItsConvert::ToNumber<int>(dateTime.substr(8, 2));
+			t.tm_hour = ItsConvert::ToNumber<int>(dateTime.substr(11, 2));
+			t.tm_min = ItsConvert::ToNumber<int>(dateTime.substr(14, 2));
+			t.tm_sec = ItsConvert::ToNumber<int>(dateTime.substr(17, 2));
+
+			return t;
+		}
+
+		static string ToLowerCase(string text)
+		{
+			ItsString::ToLowerCaseInPlace(text);
+			return text;
+		}
+
+		static string ToUpperCase(string text)
+		{
+			ItsString::ToUpperCaseInPlace(text);
+			return text;
+		}
+
+		static bool ToBool(string flag)
+		{
+			flag = ItsConvert::ToLowerCase(flag);
+
+			if (!strcmp(flag.c_str(), "true"))
+			{
+				return true;
+			}
+			else if (!strcmp(flag.c_str(), "1"))
+			{
+				return true;
+			}
+			else if (!strcmp(flag.c_str(), "yes"))
+			{
+				return true;
+			}
+			else if (!strcmp(flag.c_str(), "on"))
+			{
+				return true;
+			}
+			return false;
+		}
+
+		static string ToString(const vector<uint64_t> &pks)
+		{
+			stringstream ss;
+			bool bAddSep = false;
+			for (const auto &pk : pks)
+			{
+				if (bAddSep)
+				{
+					ss << ";";
+				}
+				ss << pk;
+				bAddSep = true;
+			}
+			string tos = ss.str();
+			return tos;
+		}
+
+		static vector<uint64_t> ToPK(const string& pks)
+		{
+			stringstream ss;
+			ss.str(string(pks.begin(), pks.end()));
+
+			string item;
+			vector<uint64_t> topk;
+			while (getline(ss, item, ';'))
+			{
+				if (!item.empty())
+				{
+					topk.push_back(ItsConvert::ToNumber<long long>(string(item.begin(), item.end())));
+				}
+			}
+
+			return topk;
+		}
+	};
+
+	//
+	// struct: ItsClock
+	//
+	// (i): Coarse wall clock with a per-thread cache of the broken-down local time.
+	//      localtime_r takes a global lock and checks the timezone on every call, so
+	//      the cache is only refreshed when the second changes.
+	//
+	struct ItsClock
+	{
+	private:
+		struct Cache
+		{
+			time_t Seconds = -1;
+			tm Local{};
+		};
+
+		static Cache& GetCache()
+		{
+			static thread_local Cache cache;
+			return cache;
+		}
+
+	public:
+		//
+		// Function: Seconds
+		//
+		// (i): Seconds since the epoch from CLOCK_REALTIME_COARSE.
+		//
+		static time_t Seconds()
+		{
+			timespec ts;
+			clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+			return ts.tv_sec;
+		}
+
+		//
+		// Function: ToLocalTime
+		//
+		// (i): localtime_r through the per-thread cache.
+		//
+		static void ToLocalTime(time_t seconds, tm* local)
+		{
+			Cache& cache = ItsClock::GetCache();
+			if (cache.Seconds != seconds)
+			{
+				::localtime_r(&seconds, &cache.Local);
+				cache.Seconds = seconds;
+			}
+			*local = cache.Local;
+		}
+
+		//
+		// Function: Now
+		//
+		// (i): Local time, second precision.
+		//
+		static tm Now()
+		{
+			tm local;
+			ItsClock::ToLocalTime(ItsClock::Seconds(), &local);
+			return local;
+		}
+
+		//
+		// Function: NowMilliseconds
+		//
+		// (i): Local time plus milliseconds within the second. Resolution is that of
+		//      CLOCK_REALTIME_COARSE, typically one scheduler tick.
+		//
+		static tm NowMilliseconds(int* milliseconds)
+		{
+			timespec ts;
+			clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+			tm local;
+			ItsClock::ToLocalTime(ts.tv_sec, &local);
+			*milliseconds = static_cast<int>(ts.tv_nsec / 1000000);
+			return local;
+		}
+
+		//
+		// Function: NowMicroseconds
+		//
+		// (i): Local time plus microseconds within the second. Uses CLOCK_REALTIME,
+		//      since the coarse clock cannot resolve microseconds.
+		//
+		static tm NowMicroseconds(int* microseconds)
+		{
+			timespec ts;
+			clock_gettime(CLOCK_REALTIME, &ts);
+			tm local;
+			ItsClock::ToLocalTime(ts.tv_sec, &local);
+			*microseconds = static_cast<int>(ts.tv_nsec / 1000);
+			return local;
+		}
+	};
+
+	//
+	// struct: ItsDateTime
+	//
+	// (i): Represents a date and time.
+	//
+	struct ItsDateTime
+	{
+	private:
+		tm m_tm;
+
+	public:
+		explicit ItsDateTime(tm timeDate)
+		{
+			this->m_tm = timeDate;
+		}
+
+		ItsDateTime(const ItsDateTime &dateTime)
+		{
+			this->m_tm = dateTime.m_tm;
+		}
+
+		ItsDateTime(ItsDateTime &&dateTime) noexcept
+		{
+			this->m_tm = dateTime.m_tm;
+		}
+
+		static ItsDateTime Now()
+		{
+			return ItsDateTime(ItsClock::Now());
+		}
+
+		bool operator==(const ItsDateTime &other)
+		{
+			if (this->m_tm.tm_year == other.m_tm.tm_year &&
+				this->m_tm.tm_mon == other.m_tm.tm_mon &&
+				this->m_tm.tm_mday == other.m_tm.tm_mday &&
+				this->m_tm.tm_hour == other.m_tm.tm_hour &&
+				this->m_tm.tm_min == other.m_tm.tm_min &&
+				this->m_tm.tm_sec == other.m_tm.tm_sec &&
+				this->m_tm.tm_wday == other.m_tm.tm_wday &&
+				this->m_tm.tm_isdst == other.m_tm.tm_isdst &&
+				this->m_tm.tm_yday == other.m_tm.tm_yday)
+			{
+				return true;
+			}
+			return false;
+		}
+
+		bool operator!=(const ItsDateTime &other)
+		{
+			if (this->m_tm.tm_year == other.m_tm.tm_year &&
+				this->m_tm.tm_mon == other.m_tm.tm_mon &&
+				this->m_tm.tm_mday == other.m_tm.tm_mday &&
+				this->m_tm.tm_hour == other.m_tm.tm_hour &&
+				this->m_tm.tm_min == other.m_tm.tm_min &&
+				this->m_tm.tm_sec == other.m_tm.tm_sec &&
+				this->m_tm.tm_wday == other.m_tm.tm_wday &&
+				this->m_tm.tm_isdst == other.m_tm.tm_isdst &&
+				this->m_tm.tm_yday == other.m_tm.tm_yday)
+			{
+				return false;
+			}
+			return true;
+		}
+
+		const ItsDateTime &operator=(const ItsDateTime &other)
+		{
+			this->m_tm.tm_year = other.m_tm.tm_year;
+			this->m_tm.tm_mon = other.m_tm.tm_mon;
+			this->m_tm.tm_mday = other.m_tm.tm_mday;
+			this->m_tm.tm_hour = other.m_tm.tm_hour;
+			this->m_tm.tm_min = other.m_tm.tm_min;
+			this->m_tm.tm_sec = other.m_tm.tm_sec;
+			this->m_tm.tm_wday = other.m_tm.tm_wday;
+			this->m_tm.tm_isdst = other.m_tm.tm_isdst;
+			this->m_tm.tm_yday = other.m_tm.tm_yday;
+
+			return *this;
+		}
+
+		explicit operator string() {
+			return this->ToString("s");
+		}
+
+		string ToString()
+		{
+			char buffer[ItsConvert::DateTimeBufferSize];
+			size_t length = ItsConvert::ToString(this->m_tm, ' ', buffer, sizeof(buffer));
+			return string(buffer, length);
+		}
+
+		string ToString(string option)
+		{
+			char buffer[256];
+			size_t length = this->ToString(option, buffer, sizeof(buffer));
+			if (length == 0 && option.size() > 0)
+			{
+				vector<char> large(option.size() * 4 + 16);
+				length = this->ToString(option, large.data(), large.size());
+				return string(large.data(), length);
+			}
+			return string(buffer, length);
+		}
+
+		//
+		// Method: ToString
+		//
+		// (i): Allocation free formatting into buffer, zero terminated. Returns the length,
+		//      or 0 if the buffer is too small. option is "s" (yyyy-MM-ddTHH:mm:ss) or a
+		//      pattern of yyyy, yy, MM, M, dd, d, HH, H, mm, m, ss and s.
+		//
+		size_t ToString(std::string_view option, char* buffer, size_t size) const
+		{
+			if (option == "s" || option == "S")
+			{
+				return ItsConvert::ToString(this->m_tm, 'T', buffer, size);
+			}
+
+			if (size == 0)
+			{
+				return 0;
+			}
+
+			char* p = buffer;
+			char* end = buffer + size - 1;
+			auto put = [&](unsigned value, size_t width) -> bool {
+				char digits[12];
+				char* d = digits + sizeof(digits);
+				do
+				{
+					*--d = static_cast<char>('0' + value % 10);
+					value /= 10;
+				} while (value > 0);
+				while (static_cast<size_t>(digits + sizeof(digits) - d) < width)
+				{
+					*--d = '0';
+				}
+				size_t n = static_cast<size_t>(digits + sizeof(digits) - d);
+				if (static_cast<size_t>(end - p) < n)
+				{
+					return false;
+				}
+				memcpy(p, d, n);
+				p += n;
+				return true;
+			};
+
+			size_t i = 0;
+			while (i < option.size())
+			{
+				char c = option[i];
+				size_t n = 1;
+				while (i + n < option.size() && option[i + n] == c)
+				{
+					n++;
+				}
+
+				bool ok = true;
+				size_t used = (n >= 2) ? 2 : 1;
+				switch (c)
+				{
+				case 'y':
+					if (n >= 4)
+					{
+						used = 4;
+						ok = put(static_cast<unsigned>(this->m_tm.tm_year + 1900), 4);
+					}
+					else if (n >= 2)
+					{
+						ok = put(static_cast<unsigned>(this->m_tm.tm_year + 1900) % 100, 2);
+					}
+					else
+					{
+						ok = (p < end);
+						if (ok)
+						{
+							*p++ = c;
+						}
+					}
+					break;
+				case 'M':
+					ok = put(static_cast<unsigned>(this->m_tm.tm_mon + 1), used);
+					break;
+				case 'd':
+					ok = put(static_cast<unsigned>(this->m_tm.tm_mday), used);
+					break;
+				case 'H':
+					ok = put(static_cast<unsigned>(this->m_tm.tm_hour), used);
+					break;
+				case 'm':
+					ok = put(static_cast<unsigned>(this->m_tm.tm_min), used);
+					break;
+				case 's':
+					ok = put(static_cast<unsigned>(this->m_tm.tm_sec), used);
+					break;
+				default:
+					used = 1;
+					ok = (p < end);
+					if (ok)
+					{
+						*p++ = c;
+					}
+					break;
+				}
+
+				if (!ok)
+				{
+					return 0;
+				}
+				i += used;
+			}
+
+			*p = '\0';
+			return static_cast<size_t>(p - buffer);
+		}
+
+		const tm &TM() const
+		{
+			return this->m_tm;
+		}
+
+		void AddYears(int year)
+		{
+			this->m_tm.tm_year += year;
+
+			mktime(&this->m_tm);
+		}
+
+		void AddMonths(int month)
+		{
+			this->m_tm.tm_mon += month;
+
+			mktime(&this->m_tm);
+		}
+
+		void AddDays(int day)
+		{
+			this->m_tm.tm_mday += day;
+
+			mktime(&this->m_tm);
+		}
+
+		void AddHours(int hour)
+		{
+			this->m_tm.tm_hour += hour;
+
+			mktime(&this->m_tm);
+		}
+
+		void AddMinutes(int min)
+		{
+			this->m_tm.tm_min += min;
+
+			mktime(&this->m_tm);
+		}
+
+		void AddSeconds(int sec)
+		{
+			this->m_tm.tm_sec += sec;
+
+			mktime(&this->m_tm);
+		}
+
+		void Add(int year, int month, int day, int hour, int min, int sec)
+		{
+			this->m_tm.tm_year += year;
+			this->m_tm.tm_mon += month;
+			this->m_tm.tm_mday += day;
+			this->m_tm.tm_hour += hour;
+			this->m_tm.tm_min += min;
+			this->m_tm.tm_sec += sec;
+
+			mktime(&this->m_tm);
+		}
+
+		void SubtractYears(int year)
+		{
+			this->m_tm.tm_year -= year;
+
+			mktime(&this->m_tm);
+		}
+
+		void SubtractMonths(int month)
+		{
+			this->m_tm.tm_mon -= month;
+
+			mktime(&this->m_tm);
+		}
+
+		void SubtractDays(int day)
+		{
+			this->m_tm.tm_mday -= day;
+
+			mktime(&this->m_tm);
+		}
+
+		void SubtractHours(int hour)
+		{
+			this->m_tm.tm_hour -= hour;
+
+			mktime(&this->m_tm);
+		}
+
+		void SubtractMinutes(int min)
+		{
+			this->m_tm.tm_min -= min;
+
+			mktime(&this->m_tm);
+		}
+
+		void SubtractSeconds(int sec)
+		{
+			this->m_tm.tm_sec -= sec;
+
+			mktime(&this->m_tm);
+		}
+
+		void Subtract(int year, int month, int day, int hour, int min, int sec)
+		{
+			this->m_tm.tm_year -= year;
+			this->m_tm.tm_mon -= month;
+			this->m_tm.tm_mday -= day;
+			this->m_tm.tm_hour -= hour;
+			this->m_tm.tm_min -= min;
+			this->m_tm.tm_sec -= sec;
 
 			mktime(&this->m_tm);
 		}
 
-		void SubtractHours(int hour)
+		int GetYear()
+		{
+			return this->m_tm.tm_year + 1900;
+		}
+
+		int GetMonth()
+		{
+			return this->m_tm.tm_mon + 1;
+		}
+
+		int GetDay()
+		{
+			return this->m_tm.tm_mday;
+		}
+
+		int GetHour()
+		{
+			return this->m_tm.tm_hour;
+		}
+
+		int GetMinute()
+		{
+			return this->m_tm.tm_min;
+		}
+
+		int GetSecond()
+		{
+			return this->m_tm.tm_sec;
+		}
+
+		ItsDateTime &operator=(const tm &timeDate)
+		{
+			this->m_tm = timeDate;
+			return *this;
+		}
+	};
+
+	//
+	// struct: ItsEpochTime
+	//
+	// (i): A point in time as int64 nanoseconds since 1970-01-01T00:00:00Z. Arithmetic and
+	//      comparison are single integer operations; the calendar breakdown (UTC) is only
+	//      computed when asked for, without mktime.
+	//
+	struct ItsEpochTime
+	{
+	public:
+		static constexpr int64_t NanosecondsPerMicrosecond = 1000;
+		static constexpr int64_t NanosecondsPerMillisecond = 1000 * NanosecondsPerMicrosecond;
+		static constexpr int64_t NanosecondsPerSecond = 1000 * NanosecondsPerMillisecond;
+		static constexpr int64_t NanosecondsPerMinute = 60 * NanosecondsPerSecond;
+		static constexpr int64_t NanosecondsPerHour = 60 * NanosecondsPerMinute;
+		static constexpr int64_t NanosecondsPerDay = 24 * NanosecondsPerHour;
+
+	private:
+		int64_t m_ns;
+
+		static constexpr int64_t FloorDiv(int64_t value, int64_t divisor)
+		{
+			int64_t q = value / divisor;
+			return (value % divisor < 0) ? q - 1 : q;
+		}
+
+		static constexpr int64_t FloorMod(int64_t value, int64_t divisor)
+		{
+			int64_t r = value % divisor;
+			return (r < 0) ? r + divisor : r;
+		}
+
+	public:
+		constexpr ItsEpochTime()
+			: m_ns(0)
+		{
+		}
+
+		constexpr explicit ItsEpochTime(int64_t nanoseconds)
+			: m_ns(nanoseconds)
+		{
+		}
+
+		static ItsEpochTime Now()
+		{
+			timespec ts;
+			clock_gettime(CLOCK_REALTIME, &ts);
+			return ItsEpochTime(static_cast<int64_t>(ts.tv_sec) * NanosecondsPerSecond + ts.tv_nsec);
+		}
+
+		static constexpr ItsEpochTime FromSeconds(int64_t seconds)
+		{
+			return ItsEpochTime(seconds * NanosecondsPerSecond);
+		}
+
+		static constexpr ItsEpochTime FromMilliseconds(int64_t milliseconds)
+		{
+			return ItsEpochTime(milliseconds * NanosecondsPerMillisecond);
+		}
+
+		//
+		// Function: DaysFromCivil
+		//
+		// (i): Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant).
+		//
+		static constexpr int64_t DaysFromCivil(int64_t year, int month, int day)
+		{
+			year -= (month <= 2) ? 1 : 0;
+			int64_t era = (year >= 0 ? year : year - 399) / 400;
+			int64_t yoe = year - era * 400;
+			int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+			int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+			return era * 146097 + doe - 719468;
+		}
+
+		//
+		// Function: CivilFromDays
+		//
+		// (i): Inverse of DaysFromCivil.
+		//
+		static constexpr void CivilFromDays(int64_t days, int64_t* year, int* month, int* day)
+		{
+			days += 719468;
+			int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+			int64_t doe = days - era * 146097;
+			int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+			int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+			int64_t mp = (5 * doy + 2) / 153;
+			int d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+			int m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+			*year = yoe + era * 400 + (m <= 2 ? 1 : 0);
+			*month = m;
+			*day = d;
+		}
+
+		static constexpr ItsEpochTime FromCivil(int64_t year, int month, int day, int hour = 0, int min = 0, int sec = 0, int64_t nanoseconds = 0)
+		{
+			return ItsEpochTime(ItsEpochTime::DaysFromCivil(year, month, day) * NanosecondsPerDay +
+								hour * NanosecondsPerHour + min * NanosecondsPerMinute + sec * NanosecondsPerSecond + nanoseconds);
+		}
+
+		//
+		// Function: FromUtc
+		//
+		// (i): From a broken-down UTC time.
+		//
+		static constexpr ItsEpochTime FromUtc(const tm& utc)
+		{
+			return ItsEpochTime::FromCivil(utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec);
+		}
+
+		//
+		// Function: FromLocal
+		//
+		// (i): From a broken-down local time. Uses mktime for the timezone offset.
+		//
+		static ItsEpochTime FromLocal(const tm& local)
+		{
+			tm t = local;
+			return ItsEpochTime::FromSeconds(static_cast<int64_t>(mktime(&t)));
+		}
+
+		static ItsEpochTime FromDateTime(const ItsDateTime& dateTime)
+		{
+			return ItsEpochTime::FromLocal(dateTime.TM());
+		}
+
+		constexpr int64_t Nanoseconds() const
+		{
+			return this->m_ns;
+		}
+
+		constexpr int64_t Milliseconds() const
+		{
+			return ItsEpochTime::FloorDiv(this->m_ns, NanosecondsPerMillisecond);
+		}
+
+		constexpr int64_t Seconds() const
+		{
+			return ItsEpochTime::FloorDiv(this->m_ns, NanosecondsPerSecond);
+		}
+
+		constexpr int64_t Days() const
+		{
+			return ItsEpochTime::FloorDiv(this->m_ns, NanosecondsPerDay);
+		}
+
+		constexpr ItsEpochTime& AddDays(int64_t days)
+		{
+			this->m_ns += days * NanosecondsPerDay;
+			return *this;
+		}
+
+		constexpr ItsEpochTime& AddHours(int64_t hours)
+		{
+			this->m_ns += hours * NanosecondsPerHour;
+			return *this;
+		}
+
+		constexpr ItsEpochTime& AddMinutes(int64_t minutes)
+		{
+			this->m_ns += minutes * NanosecondsPerMinute;
+			return *this;
+		}
+
+		constexpr ItsEpochTime& AddSeconds(int64_t seconds)
+		{
+			this->m_ns += seconds * NanosecondsPerSecond;
+			return *this;
+		}
+
+		constexpr ItsEpochTime& AddMilliseconds(int64_t milliseconds)
+		{
+			this->m_ns += milliseconds * NanosecondsPerMillisecond;
+			return *this;
+		}
+
+		constexpr ItsEpochTime& AddNanoseconds(int64_t nanoseconds)
+		{
+			this->m_ns += nanoseconds;
+			return *this;
+		}
+
+		//
+		// Method: Truncate
+		//
+		// (i): Rounds down to a multiple of interval nanoseconds, e.g. NanosecondsPerHour,
+		//      for bucketing.
+		//
+		constexpr ItsEpochTime Truncate(int64_t interval) const
+		{
+			return ItsEpochTime(this->m_ns - ItsEpochTime::FloorMod(this->m_ns, interval));
+		}
+
+		constexpr int GetYear() const
+		{
+			int64_t year = 0;
+			int month = 0, day = 0;
+			ItsEpochTime::CivilFromDays(this->Days(), &year, &month, &day);
+			return static_cast<int>(year);
+		}
+
+		constexpr int GetMonth() const
+		{
+			int64_t year = 0;
+			int month = 0, day = 0;
+			ItsEpochTime::CivilFromDays(this->Days(), &year, &month, &day);
+			return month;
+		}
+
+		constexpr int GetDay() const
+		{
+			int64_t year = 0;
+			int month = 0, day = 0;
+			ItsEpochTime::CivilFromDays(this->Days(), &year, &month, &day);
+			return day;
+		}
+
+		constexpr int GetHour() const
+		{
+			return static_cast<int>(ItsEpochTime::FloorMod(this->m_ns, NanosecondsPerDay) / NanosecondsPerHour);
+		}
+
+		constexpr int GetMinute() const
+		{
+			return static_cast<int>(ItsEpochTime::FloorMod(this->m_ns, NanosecondsPerHour) / NanosecondsPerMinute);
+		}
+
+		constexpr int GetSecond() const
+		{
+			return static_cast<int>(ItsEpochTime::FloorMod(this->m_ns, NanosecondsPerMinute) / NanosecondsPerSecond);
+		}
+
+		constexpr int GetNanosecond() const
+		{
+			return static_cast<int>(ItsEpochTime::FloorMod(this->m_ns, NanosecondsPerSecond));
+		}
+
+		//
+		// Method: GetDayOfWeek
+		//
+		// (i): 0 = Sunday, as tm_wday.
+		//
+		constexpr int GetDayOfWeek() const
+		{
+			return static_cast<int>(ItsEpochTime::FloorMod(this->Days() + 4, 7));
+		}
+
+		//
+		// Method: ToUtcTM
+		//
+		// (i): Broken-down UTC time, including tm_wday and tm_yday.
+		//
+		tm ToUtcTM() const
+		{
+			int64_t days = this->Days();
+			int64_t year = 0;
+			int month = 0, day = 0;
+			ItsEpochTime::CivilFromDays(days, &year, &month, &day);
+
+			tm t{};
+			t.tm_year = static_cast<int>(year - 1900);
+			t.tm_mon = month - 1;
+			t.tm_mday = day;
+			t.tm_hour = this->GetHour();
+			t.tm_min = this->GetMinute();
+			t.tm_sec = this->GetSecond();
+			t.tm_wday = this->GetDayOfWeek();
+			t.tm_yday = static_cast<int>(days - ItsEpochTime::DaysFromCivil(year, 1, 1));
+			return t;
+		}
+
+		//
+		// Method: ToDateTime
+		//
+		// (i): Local time as ItsDateTime.
+		//
+		ItsDateTime ToDateTime() const
+		{
+			tm local;
+			ItsClock::ToLocalTime(static_cast<time_t>(this->Seconds()), &local);
+			return ItsDateTime(local);
+		}
+
+		//
+		// Method: ToString
+		//
+		// (i): UTC ISO-8601 with milliseconds, "yyyy-MM-ddTHH:mm:ss.fffZ".
+		//
+		string ToString() const
+		{
+			char buffer[ItsConvert::DateTimeBufferSize + 8];
+			size_t length = ItsConvert::ToString(this->ToUtcTM(), 'T', buffer, sizeof(buffer));
+			if (length == 0)
+			{
+				return string();
+			}
+			unsigned ms = static_cast<unsigned>(this->GetNanosecond() / NanosecondsPerMillisecond);
+			char* p = buffer + length;
+			*p++ = '.';
+			*p++ = static_cast<char>('0' + ms / 100);
+			p = ItsDigits::Write2(p, ms % 100);
+			*p++ = 'Z';
+			return string(buffer, static_cast<size_t>(p - buffer));
+		}
+
+		constexpr int64_t operator-(const ItsEpochTime& other) const
+		{
+			return this->m_ns - other.m_ns;
+		}
+
+		constexpr ItsEpochTime operator+(int64_t nanoseconds) const
+		{
+			return ItsEpochTime(this->m_ns + nanoseconds);
+		}
+
+		constexpr ItsEpochTime operator-(int64_t nanoseconds) const
+		{
+			return ItsEpochTime(this->m_ns - nanoseconds);
+		}
+
+		constexpr bool operator==(const ItsEpochTime& other) const
+		{
+			return this->m_ns == other.m_ns;
+		}
+
+		constexpr bool operator!=(const ItsEpochTime& other) const
+		{
+			return this->m_ns != other.m_ns;
+		}
+
+		constexpr bool operator<(const ItsEpochTime& other) const
+		{
+			return this->m_ns < other.m_ns;
+		}
+
+		constexpr bool operator<=(const ItsEpochTime& other) const
+		{
+			return this->m_ns <= other.m_ns;
+		}
+
+		constexpr bool operator>(const ItsEpochTime& other) const
+		{
+			return this->m_ns > other.m_ns;
+		}
+
+		constexpr bool operator>=(const ItsEpochTime& other) const
+		{
+			return this->m_ns >= other.m_ns;
+		}
+	};
+
+	//
+	// struct: ItsSplitMix64
+	//
+	// (i): SplitMix64, used to expand a single 64 bit seed into generator state.
+	//
+	struct ItsSplitMix64
+	{
+		using result_type = uint64_t;
+
+		uint64_t State;
+
+		explicit constexpr ItsSplitMix64(uint64_t seed = 0) : State(seed) {}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT64_MAX; }
+
+		constexpr result_type operator()()
+		{
+			uint64_t z = (this->State += 0x9E3779B97F4A7C15ULL);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		}
+	};
+
+	//
+	// class: ItsXoshiro256StarStar
+	//
+	// (i): xoshiro256** (Blackman/Vigna), 32 bytes of state, period 2^256 - 1.
+	//      Jump advances 2^128 and LongJump 2^192 values, to split one seed into
+	//      non-overlapping parallel streams.
+	//
+	class ItsXoshiro256StarStar
+	{
+	private:
+		uint64_t m_s[4];
+
+		static constexpr uint64_t Rotl(uint64_t x, int k)
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+		void Jump(const uint64_t (&polynomial)[4])
+		{
+			uint64_t s[4]{ 0, 0, 0, 0 };
+			for (uint64_t word : polynomial) {
+				for (int b = 0; b < 64; b++) {
+					if (word & (1ULL << b)) {
+						for (int i = 0; i < 4; i++) {
+							s[i] ^= this->m_s[i];
+						}
+					}
+					(*this)();
+				}
+			}
+			memcpy(this->m_s, s, sizeof(s));
+		}
+	public:
+		using result_type = uint64_t;
+
+		explicit ItsXoshiro256StarStar(uint64_t seed = 0x2545F4914F6CDD1DULL)
+		{
+			this->Seed(seed);
+		}
+
+		void Seed(uint64_t seed)
+		{
+			ItsSplitMix64 sm(seed);
+			for (uint64_t& s : this->m_s) {
+				s = sm();
+			}
+		}
+
+		//
+		// Method: SetState
+		//
+		// (i): Sets the full 256 bit state, e.g. from getrandom. False, state unchanged,
+		//      for the all zero state, which xoshiro never leaves.
+		//
+		bool SetState(const uint64_t (&state)[4])
+		{
+			if ((state[0] | state[1] | state[2] | state[3]) == 0) {
+				return false;
+			}
+			memcpy(this->m_s, state, sizeof(this->m_s));
+			return true;
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT64_MAX; }
+
+		result_type operator()()
+		{
+			uint64_t* s = this->m_s;
+			uint64_t result = Rotl(s[1] * 5, 7) * 9;
+			uint64_t t = s[1] << 17;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = Rotl(s[3], 45);
+			return result;
+		}
+
+		void Jump()
+		{
+			static constexpr uint64_t polynomial[4]{ 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+			this->Jump(polynomial);
+		}
+
+		void LongJump()
+		{
+			static constexpr uint64_t polynomial[4]{ 0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL, 0x77710069854EE241ULL, 0x39109BB02ACBE635ULL };
+			this->Jump(polynomial);
+		}
+
+		const uint64_t* GetState() const
+		{
+			return this->m_s;
+		}
+	};
+
+	//
+	// class: ItsXoshiro256StarStarX8
+	//
+	// (i): Eight interleaved xoshiro256** streams, each a Jump apart, stepped together
+	//      (two AVX2 register sets when available, to hide the xorshift latency) for
+	//      bulk generation. Produces the same sequence through operator() and Fill.
+	//
+	class ItsXoshiro256StarStarX8
+	{
+	private:
+		static constexpr size_t Lanes = 8;
+		alignas(32) uint64_t m_s[4][Lanes];
+		alignas(32) uint64_t m_buffer[Lanes];
+		size_t m_index = Lanes;
+
+#ifdef ITS_SIMD_AVX2
+		static void Step(__m256i& s0, __m256i& s1, __m256i& s2, __m256i& s3, uint64_t* out)
+		{
+			__m256i x5 = _mm256_add_epi64(s1, _mm256_slli_epi64(s1, 2));
+			__m256i r = _mm256_or_si256(_mm256_slli_epi64(x5, 7), _mm256_srli_epi64(x5, 57));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_add_epi64(r, _mm256_slli_epi64(r, 3)));
+			__m256i t = _mm256_slli_epi64(s1, 17);
+			s2 = _mm256_xor_si256(s2, s0);
+			s3 = _mm256_xor_si256(s3, s1);
+			s1 = _mm256_xor_si256(s1, s2);
+			s0 = _mm256_xor_si256(s0, s3);
+			s2 = _mm256_xor_si256(s2, t);
+			s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+		}
+#endif
+		// count is a multiple of Lanes
+		static void Generate(uint64_t (&s)[4][Lanes], uint64_t* out, size_t count)
+		{
+#ifdef ITS_SIMD_AVX2
+			__m256i a0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[0][0]));
+			__m256i a1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[1][0]));
+			__m256i a2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[2][0]));
+			__m256i a3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[3][0]));
+			__m256i b0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[0][4]));
+			__m256i b1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[1][4]));
+			__m256i b2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[2][4]));
+			__m256i b3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(&s[3][4]));
+			for (size_t i = 0; i < count; i += Lanes) {
+				Step(a0, a1, a2, a3, out + i);
+				Step(b0, b1, b2, b3, out + i + 4);
+			}
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&s[0][0]), a0);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&s[1][0]), a1);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&s[2][0]), a2);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&s[3][0]), a3);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&s[0][4]), b0);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&s[1][4]), b1);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&s[2][4]), b2);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&s[3][4]), b3);
+#else
+			// (i): Step a local copy so the lanes can stay in (SSE2) registers.
+			alignas(32) uint64_t l[4][Lanes];
+			memcpy(l, s, sizeof(l));
+			for (size_t i = 0; i < count; i += Lanes) {
+				for (size_t lane = 0; lane < Lanes; lane++) {
+					uint64_t x5 = l[1][lane] * 5;
+					out[i + lane] = ((x5 << 7) | (x5 >> 57)) * 9;
+					uint64_t t = l[1][lane] << 17;
+					l[2][lane] ^= l[0][lane];
+					l[3][lane] ^= l[1][lane];
+					l[1][lane] ^= l[2][lane];
+					l[0][lane] ^= l[3][lane];
+					l[2][lane] ^= t;
+					l[3][lane] = (l[3][lane] << 45) | (l[3][lane] >> 19);
+				}
+			}
+			memcpy(s, l, sizeof(l));
+#endif
+		}
+	public:
+		using result_type = uint64_t;
+
+		explicit ItsXoshiro256StarStarX8(uint64_t seed = 0x2545F4914F6CDD1DULL)
+		{
+			this->Seed(seed);
+		}
+
+		void Seed(uint64_t seed)
+		{
+			ItsXoshiro256StarStar g(seed);
+			for (size_t lane = 0; lane < Lanes; lane++) {
+				for (int i = 0; i < 4; i++) {
+					this->m_s[i][lane] = g.GetState()[i];
+				}
+				g.Jump();
+			}
+			this->m_index = Lanes;
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT64_MAX; }
+
+		result_type operator()()
+		{
+			if (this->m_index == Lanes) {
+				ItsXoshiro256StarStarX8::Generate(this->m_s, this->m_buffer, Lanes);
+				this->m_index = 0;
+			}
+			return this->m_buffer[this->m_index++];
+		}
+
+		//
+		// Method: Fill
+		//
+		// (i): Writes count raw 64 bit values to values.
+		//
+		void Fill(uint64_t* values, size_t count)
+		{
+			size_t i = 0;
+			for (; i < count && this->m_index < Lanes; i++) {
+				values[i] = this->m_buffer[this->m_index++];
+			}
+			size_t blocks = (count - i) / Lanes * Lanes;
+			ItsXoshiro256StarStarX8::Generate(this->m_s, values + i, blocks);
+			for (i += blocks; i < count; i++) {
+				values[i] = (*this)();
+			}
+		}
+	};
+
+	//
+	// class: ItsPcg32
+	//
+	// (i): PCG32 (XSH RR 64/32, O'Neill), 16 bytes of state and 32 bit output.
+	//      Generators with different stream values never overlap; Advance skips
+	//      ahead in O(log n).
+	//
+	class ItsPcg32
+	{
+	private:
+		uint64_t m_state = 0;
+		uint64_t m_inc = 1;
+		static constexpr uint64_t Multiplier = 6364136223846793005ULL;
+	public:
+		using result_type = uint32_t;
+
+		explicit ItsPcg32(uint64_t seed = 0x853C49E6748FEA9BULL, uint64_t stream = 0xDA3E39CB94B95BDBULL)
+		{
+			this->Seed(seed, stream);
+		}
+
+		void Seed(uint64_t seed, uint64_t stream = 0xDA3E39CB94B95BDBULL)
+		{
+			this->m_state = 0;
+			this->m_inc = (stream << 1) | 1;
+			(*this)();
+			this->m_state += seed;
+			(*this)();
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT32_MAX; }
+
+		result_type operator()()
+		{
+			uint64_t old = this->m_state;
+			this->m_state = old * Multiplier + this->m_inc;
+			uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+			uint32_t rot = static_cast<uint32_t>(old >> 59);
+			return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31));
+		}
+
+		void Advance(uint64_t delta)
+		{
+			uint64_t multiplier = Multiplier;
+			uint64_t increment = this->m_inc;
+			uint64_t accMultiplier = 1;
+			uint64_t accIncrement = 0;
+			while (delta > 0) {
+				if (delta & 1) {
+					accMultiplier *= multiplier;
+					accIncrement = accIncrement * multiplier + increment;
+				}
+				increment = (multiplier + 1) * increment;
+				multiplier *= multiplier;
+				delta >>= 1;
+			}
+			this->m_state = accMultiplier * this->m_state + accIncrement;
+		}
+	};
+
+	//
+	// class: ItsWyRand
+	//
+	// (i): wyrand (Wang Yi), 8 bytes of state, the fastest of the family. Period 2^64.
+	//
+	class ItsWyRand
+	{
+	private:
+		uint64_t m_state;
+		static constexpr uint64_t Increment = 0xA0761D6478BD642FULL;
+	public:
+		using result_type = uint64_t;
+
+		explicit constexpr ItsWyRand(uint64_t seed = 0) : m_state(seed) {}
+
+		void Seed(uint64_t seed)
+		{
+			this->m_state = seed;
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT64_MAX; }
+
+		result_type operator()()
+		{
+			this->m_state += Increment;
+			__uint128_t m = static_cast<__uint128_t>(this->m_state) * (this->m_state ^ 0xE7037ED1A0B428DBULL);
+			return static_cast<uint64_t>(m >> 64) ^ static_cast<uint64_t>(m);
+		}
+
+		void Advance(uint64_t delta)
+		{
+			this->m_state += delta * Increment;
+		}
+	};
+
+	//
+	// struct: ItsForkGeneration
+	//
+	// (i): Counter bumped in the child after every fork(), for per thread state that
+	//      must not be shared between parent and child (random generator seeds).
+	//
+	struct ItsForkGeneration
+	{
+	private:
+		static std::atomic<uint32_t>& Counter()
+		{
+			static std::atomic<uint32_t> counter{ 1 };
+			return counter;
+		}
+		static void OnFork()
+		{
+			ItsForkGeneration::Counter().fetch_add(1, std::memory_order_relaxed);
+		}
+	public:
+		static uint32_t Get()
+		{
+			static const bool registered = (pthread_atfork(nullptr, nullptr, &ItsForkGeneration::OnFork) == 0);
+			(void)registered;
+			return ItsForkGeneration::Counter().load(std::memory_order_relaxed);
+		}
+	};
+
+	//
+	// class: ItsChaCha20Random
+	//
+	// (i): Cryptographically secure generator: a ChaCha20 keystream keyed from getrandom,
+	//      generated 1 KB at a time (four blocks per step with SSE2). The first 32 bytes
+	//      of every refill become the next key and served bytes are wiped (fast key
+	//      erasure), the key is replaced from getrandom every 1 MB and in a forked child.
+	//      Use ThreadLocal() for the per thread instance. The seed constructor is
+	//      deterministic and for tests only.
+	//
+	class ItsChaCha20Random
+	{
+	private:
+		static constexpr size_t BufferSize = 1024;
+		static constexpr size_t KeySize = 32;
+		static constexpr uint64_t ReseedBytes = 1 << 20;
+
+		uint32_t m_key[8]{ 0 };
+		alignas(16) uint8_t m_buffer[BufferSize]{ 0 };
+		size_t m_position = BufferSize;
+		uint64_t m_bytesSinceReseed = 0;
+		uint32_t m_generation = 0;
+		bool m_deterministic = false;
+
+		static constexpr uint32_t Rotl(uint32_t x, int k)
+		{
+			return (x << k) | (x >> (32 - k));
+		}
+		static void QuarterRound(uint32_t* x, int a, int b, int c, int d)
+		{
+			x[a] += x[b]; x[d] = Rotl(x[d] ^ x[a], 16);
+			x[c] += x[d]; x[b] = Rotl(x[b] ^ x[c], 12);
+			x[a] += x[b]; x[d] = Rotl(x[d] ^ x[a], 8);
+			x[c] += x[d]; x[b] = Rotl(x[b] ^ x[c], 7);
+		}
+		static void InitState(uint32_t* state, const uint32_t (&key)[8], uint32_t counter, const uint32_t (&nonce)[3])
+		{
+			state[0] = 0x61707865;
+			state[1] = 0x3320646E;
+			state[2] = 0x79622D32;
+			state[3] = 0x6B206574;
+			memcpy(&state[4], key, sizeof(key));
+			state[12] = counter;
+			memcpy(&state[13], nonce, sizeof(nonce));
+		}
+		static void StoreWord(uint8_t* out, uint32_t v)
+		{
+			v = htole32(v);
+			memcpy(out, &v, sizeof(v));
+		}
+#ifdef ITS_SIMD_SSE2
+		static __m128i Rotl128(__m128i x, int k)
+		{
+			return _mm_or_si128(_mm_slli_epi32(x, k), _mm_srli_epi32(x, 32 - k));
+		}
+		static void QuarterRound128(__m128i* x, int a, int b, int c, int d)
+		{
+			x[a] = _mm_add_epi32(x[a], x[b]); x[d] = Rotl128(_mm_xor_si128(x[d], x[a]), 16);
+			x[c] = _mm_add_epi32(x[c], x[d]); x[b] = Rotl128(_mm_xor_si128(x[b], x[c]), 12);
+			x[a] = _mm_add_epi32(x[a], x[b]); x[d] = Rotl128(_mm_xor_si128(x[d], x[a]), 8);
+			x[c] = _mm_add_epi32(x[c], x[d]); x[b] = Rotl128(_mm_xor_si128(x[b], x[c]), 7);
+		}
+		// four consecutive blocks, one per 32 bit lane
+		static void Blocks4(const uint32_t* state, uint8_t* out)
+		{
+			__m128i in[16];
+			__m128i x[16];
+			for (int i = 0; i < 16; i++) {
+				in[i] = _mm_set1_epi32(static_cast<int>(state[i]));
+			}
+			in[12] = _mm_add_epi32(in[12], _mm_set_epi32(3, 2, 1, 0));
+			for (int i = 0; i < 16; i++) {
+				x[i] = in[i];
+			}
+			for (int round = 0; round < 10; round++) {
+				QuarterRound128(x, 0, 4, 8, 12);
+				QuarterRound128(x, 1, 5, 9, 13);
+				QuarterRound128(x, 2, 6, 10, 14);
+				QuarterRound128(x, 3, 7, 11, 15);
+				QuarterRound128(x, 0, 5, 10, 15);
+				QuarterRound128(x, 1, 6, 11, 12);
+				QuarterRound128(x, 2, 7, 8, 13);
+				QuarterRound128(x, 3, 4, 9, 14);
+			}
+			// (i): 4x4 transposes turn word lanes back into consecutive (little endian) blocks.
+			for (int i = 0; i < 16; i += 4) {
+				__m128i a = _mm_add_epi32(x[i], in[i]);
+				__m128i b = _mm_add_epi32(x[i + 1], in[i + 1]);
+				__m128i c = _mm_add_epi32(x[i + 2], in[i + 2]);
+				__m128i d = _mm_add_epi32(x[i + 3], in[i + 3]);
+				__m128i ab0 = _mm_unpacklo_epi32(a, b);
+				__m128i ab1 = _mm_unpackhi_epi32(a, b);
+				__m128i cd0 = _mm_unpacklo_epi32(c, d);
+				__m128i cd1 = _mm_unpackhi_epi32(c, d);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0 * 64 + i * 4), _mm_unpacklo_epi64(ab0, cd0));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 1 * 64 + i * 4), _mm_unpackhi_epi64(ab0, cd0));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * 64 + i * 4), _mm_unpacklo_epi64(ab1, cd1));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 3 * 64 + i * 4), _mm_unpackhi_epi64(ab1, cd1));
+			}
+		}
+#endif
+		void Refill()
+		{
+			if (!this->m_deterministic && (this->m_generation != ItsForkGeneration::Get() || this->m_bytesSinceReseed >= ReseedBytes)) {
+				this->Reseed();
+			}
+			static constexpr uint32_t nonce[3]{ 0, 0, 0 };
+			ItsChaCha20Random::Keystream(this->m_key, nonce, 0, this->m_buffer, BufferSize / 64);
+			memcpy(this->m_key, this->m_buffer, KeySize);
+			memset(this->m_buffer, 0, KeySize);
+			this->m_position = KeySize;
+			this->m_bytesSinceReseed += BufferSize - KeySize;
+		}
+	public:
+		using result_type = uint64_t;
+
+		ItsChaCha20Random()
+		{
+			this->Reseed();
+		}
+
+		explicit ItsChaCha20Random(uint64_t seed)
+			: m_deterministic(true)
+		{
+			ItsSplitMix64 sm(seed);
+			for (size_t i = 0; i < 8; i += 2) {
+				uint64_t v = sm();
+				this->m_key[i] = static_cast<uint32_t>(v);
+				this->m_key[i + 1] = static_cast<uint32_t>(v >> 32);
+			}
+		}
+
+		~ItsChaCha20Random()
+		{
+			explicit_bzero(this->m_key, sizeof(this->m_key));
+			explicit_bzero(this->m_buffer, sizeof(this->m_buffer));
+		}
+
+		ItsChaCha20Random(const ItsChaCha20Random&) = delete;
+		ItsChaCha20Random& operator=(const ItsChaCha20Random&) = delete;
+
+		//
+		// Method: Reseed
+		//
+		// (i): Replaces the key with 32 bytes from getrandom (/dev/urandom if the syscall
+		//      is missing) and drops buffered output. Aborts if neither is available,
+		//      as arc4random does, rather than hand out predictable values.
+		//
+		void Reseed()
+		{
+			uint8_t* key = reinterpret_cast<uint8_t*>(this->m_key);
+			size_t got = 0;
+			while (got < KeySize) {
+				ssize_t n = getrandom(key + got, KeySize - got, 0);
+				if (n < 0 && errno == EINTR) {
+					continue;
+				}
+				if (n <= 0) {
+					break;
+				}
+				got += static_cast<size_t>(n);
+			}
+			if (got < KeySize) {
+				int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+				while (fd >= 0 && got < KeySize) {
+					ssize_t n = read(fd, key + got, KeySize - got);
+					if (n < 0 && errno == EINTR) {
+						continue;
+					}
+					if (n <= 0) {
+						break;
+					}
+					got += static_cast<size_t>(n);
+				}
+				if (fd >= 0) {
+					close(fd);
+				}
+			}
+			if (got < KeySize) {
+				fprintf(stderr, "ItsChaCha20Random: no entropy source available\n");
+				abort();
+			}
+			explicit_bzero(this->m_buffer, sizeof(this->m_buffer));
+			this->m_position = BufferSize;
+			this->m_bytesSinceReseed = 0;
+			this->m_generation = ItsForkGeneration::Get();
+			this->m_deterministic = false;
+		}
+
+		//
+		// Function: Keystream
+		//
+		// (i): RFC 8439 ChaCha20 keystream, blocks 64 byte blocks from counter into out.
+		//
+		static void Keystream(const uint32_t (&key)[8], const uint32_t (&nonce)[3], uint32_t counter, uint8_t* out, size_t blocks)
+		{
+			uint32_t state[16];
+			size_t block = 0;
+#ifdef ITS_SIMD_SSE2
+			for (; block + 4 <= blocks; block += 4) {
+				InitState(state, key, counter + static_cast<uint32_t>(block), nonce);
+				Blocks4(state, out + block * 64);
+			}
+#endif
+			for (; block < blocks; block++) {
+				InitState(state, key, counter + static_cast<uint32_t>(block), nonce);
+				uint32_t x[16];
+				memcpy(x, state, sizeof(x));
+				for (int round = 0; round < 10; round++) {
+					QuarterRound(x, 0, 4, 8, 12);
+					QuarterRound(x, 1, 5, 9, 13);
+					QuarterRound(x, 2, 6, 10, 14);
+					QuarterRound(x, 3, 7, 11, 15);
+					QuarterRound(x, 0, 5, 10, 15);
+					QuarterRound(x, 1, 6, 11, 12);
+					QuarterRound(x, 2, 7, 8, 13);
+					QuarterRound(x, 3, 4, 9, 14);
+				}
+				for (int i = 0; i < 16; i++) {
+					StoreWord(out + block * 64 + i * 4, x[i] + state[i]);
+				}
+			}
+		}
+
+		//
+		// Function: ThreadLocal
+		//
+		// (i): Returns the calling thread's generator.
+		//
+		static ItsChaCha20Random& ThreadLocal()
+		{
+			static thread_local ItsChaCha20Random generator;
+			return generator;
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT64_MAX; }
+
+		result_type operator()()
+		{
+			uint64_t value;
+			if (this->m_position + sizeof(value) <= BufferSize && (this->m_deterministic || this->m_generation == ItsForkGeneration::Get())) {
+				memcpy(&value, this->m_buffer + this->m_position, sizeof(value));
+				memset(this->m_buffer + this->m_position, 0, sizeof(value));
+				this->m_position += sizeof(value);
+				return value;
+			}
+			this->Fill(&value, sizeof(value));
+			return value;
+		}
+
+		//
+		// Method: Fill
+		//
+		// (i): Writes size random bytes to data.
+		//
+		void Fill(void* data, size_t size)
+		{
+			uint8_t* out = static_cast<uint8_t*>(data);
+			while (size > 0) {
+				if (this->m_position == BufferSize || (!this->m_deterministic && this->m_generation != ItsForkGeneration::Get())) {
+					this->Refill();
+				}
+				size_t n = std::min(size, BufferSize - this->m_position);
+				memcpy(out, this->m_buffer + this->m_position, n);
+				memset(this->m_buffer + this->m_position, 0, n);
+				this->m_position += n;
+				out += n;
+				size -= n;
+			}
+		}
+	};
+
+	//
+	// struct: ItsRandomBits
+	//
+	// (i): Maps raw generator output to ranges without std distributions: Lemire's
+	//      multiply-shift for integers, 53/24 high bits for double/float.
+	//
+	struct ItsRandomBits
+	{
+		template <typename Generator>
+		static uint64_t Next64(Generator& gen)
+		{
+			using result_type = typename Generator::result_type;
+			if constexpr (Generator::min() == 0 && Generator::max() == UINT64_MAX) {
+				return static_cast<uint64_t>(gen());
+			}
+			else if constexpr (Generator::min() == 0 && Generator::max() == UINT32_MAX) {
+				uint64_t hi = static_cast<uint64_t>(gen());
+				return (hi << 32) | static_cast<uint64_t>(gen());
+			}
+			else {
+				static_assert(std::is_unsigned<result_type>::value, "Generator result_type must be unsigned");
+				return std::uniform_int_distribution<uint64_t>{}(gen);
+			}
+		}
+
+		template <typename Generator>
+		static void Fill(Generator& gen, uint64_t* values, size_t count)
+		{
+			if constexpr (std::is_same<Generator, ItsXoshiro256StarStarX8>::value) {
+				gen.Fill(values, count);
+			}
+			else if constexpr (std::is_same<Generator, ItsChaCha20Random>::value) {
+				gen.Fill(values, count * sizeof(uint64_t));
+			}
+			else {
+				for (size_t i = 0; i < count; i++) {
+					values[i] = ItsRandomBits::Next64(gen);
+				}
+			}
+		}
+
+		// uniform in [0, range), range 0 meaning 2^64
+		template <typename Generator>
+		static uint64_t Bounded(Generator& gen, uint64_t bits, uint64_t range)
+		{
+			if (range == 0) {
+				return bits;
+			}
+			__uint128_t m = static_cast<__uint128_t>(bits) * range;
+			uint64_t low = static_cast<uint64_t>(m);
+			if (low < range) {
+				uint64_t threshold = (0 - range) % range;
+				while (low < threshold) {
+					m = static_cast<__uint128_t>(ItsRandomBits::Next64(gen)) * range;
+					low = static_cast<uint64_t>(m);
+				}
+			}
+			return static_cast<uint64_t>(m >> 64);
+		}
+
+		// integers in [from, to], reals in [from, to)
+		template <typename Numeric, typename Generator>
+		static Numeric Map(Generator& gen, uint64_t bits, Numeric from, Numeric to)
+		{
+			if constexpr (std::is_integral<Numeric>::value) {
+				uint64_t range = static_cast<uint64_t>(to) - static_cast<uint64_t>(from) + 1;
+				return static_cast<Numeric>(static_cast<uint64_t>(from) + ItsRandomBits::Bounded(gen, bits, range));
+			}
+			else if constexpr (std::is_same<Numeric, float>::value) {
+				return from + static_cast<float>(bits >> 40) * 0x1.0p-24f * (to - from);
+			}
+			else {
+				return from + static_cast<Numeric>(static_cast<double>(bits >> 11) * 0x1.0p-53) * (to - from);
+			}
+		}
+	};
+
+	//
+	// Function: ItsRandomEngine
+	//
+	// (i): The calling thread's Generator, shared by ItsRandom, ItsRandomFill and
+	//      ItsRandomSeed. Seeded from std::random_device on first use.
+	//      ItsRandom<T, ItsChaCha20Random> is the cryptographically secure variant.
+	//
+	template <typename Generator = ItsXoshiro256StarStar>
+	Generator& ItsRandomEngine()
+	{
+		thread_local static Generator gen([] {
+			std::random_device rd;
+			return (static_cast<uint64_t>(rd()) << 32) | rd();
+		}());
+		return gen;
+	}
+
+	// (i): The secure engine is keyed from getrandom, never from a 64 bit seed.
+	template <>
+	inline ItsChaCha20Random& ItsRandomEngine<ItsChaCha20Random>()
+	{
+		return ItsChaCha20Random::ThreadLocal();
+	}
+
+	//
+	// Function: ItsRandomSeed
+	//
+	// (i): Reseeds the calling thread's Generator for reproducible sequences.
+	//
+	template <typename Generator = ItsXoshiro256StarStar>
+	void ItsRandomSeed(uint64_t seed)
+	{
+		static_assert(!std::is_same<Generator, ItsChaCha20Random>::value, "ItsChaCha20Random is always seeded from getrandom");
+		ItsRandomEngine<Generator>() = Generator(seed);
+	}
+
+	//
+	// Function: ItsRandom
+	//
+	// (i): A random number wrapper. Integers in [from, to], reals in [from, to).
+	//
+	template <typename Numeric, typename Generator = ItsXoshiro256StarStar>
+	Numeric ItsRandom(Numeric from, Numeric to)
+	{
+		Generator& gen = ItsRandomEngine<Generator>();
+		return ItsRandomBits::Map<Numeric>(gen, ItsRandomBits::Next64(gen), from, to);
+	}
+
+	//
+	// Function: ItsRandomFill
+	//
+	// (i): Bulk ItsRandom, fills values with count numbers from gen in blocks.
+	//
+	template <typename Numeric, typename Generator>
+	void ItsRandomFill(Generator& gen, Numeric* values, size_t count, Numeric from, Numeric to)
+	{
+		uint64_t bits[256];
+		for (size_t i = 0; i < count; i += 256) {
+			size_t n = std::min<size_t>(256, count - i);
+			ItsRandomBits::Fill(gen, bits, n);
+			for (size_t j = 0; j < n; j++) {
+				values[i + j] = ItsRandomBits::Map<Numeric>(gen, bits[j], from, to);
+			}
+		}
+	}
+
+	template <typename Numeric, typename Generator = ItsXoshiro256StarStar>
+	void ItsRandomFill(Numeric* values, size_t count, Numeric from, Numeric to)
+	{
+		ItsRandomFill<Numeric>(ItsRandomEngine<Generator>(), values, count, from, to);
+	}
+
+	//
+	// forward declare
+	//
+	struct ItsLog;
+
+	//
+	// ItsLogType
+	//
+	// (i): Log type for ItsLogItem
+	//
+	enum class ItsLogType
+	{
+		Information,
+		Warning,
+		Error,
+		Other,
+		Debug
+	};
+
+	//
+	// ItsLogUtil
+	//
+	// (i): Convertion misc. methods.
+	//
+	struct ItsLogUtil
+	{
+		static constexpr const char* LogTypeToString(ItsLogType t)
+		{
+			switch (t)
+			{
+			case ItsLogType::Information:
+				return "Information";
+				break;
+			case ItsLogType::Warning:
+				return "Warning";
+				break;
+			case ItsLogType::Error:
+				return "Error";
+				break;
+			case ItsLogType::Other:
+				return "Other";
+				break;
+			case ItsLogType::Debug:
+				return "Debug";
+				break;
+			default:
+				break;
+			}
+			return "Unknown";
+		}
+
+		//
+		// Function: LogTypeToLevel
+		//
+		// (i): Severity of a log type. Debug < Information < Other < Warning < Error.
+		//
+		static constexpr int LogTypeToLevel(ItsLogType t)
+		{
+			switch (t)
+			{
+			case ItsLogType::Debug:
+				return 0;
+			case ItsLogType::Information:
+				return 1;
+			case ItsLogType::Other:
+				return 2;
+			case ItsLogType::Warning:
+				return 3;
+			case ItsLogType::Error:
+				return 4;
+			default:
+				break;
+			}
+			return 1;
+		}
+
+		static constexpr int LogTypeToSyslogPriority(ItsLogType t)
+		{
+			switch (t)
+			{
+			case ItsLogType::Debug:
+				return LOG_DEBUG;
+			case ItsLogType::Information:
+				return LOG_INFO;
+			case ItsLogType::Other:
+				return LOG_NOTICE;
+			case ItsLogType::Warning:
+				return LOG_WARNING;
+			case ItsLogType::Error:
+				return LOG_ERR;
+			default:
+				break;
+			}
+			return LOG_INFO;
+		}
+
+		//
+		// Function: IsEnabledAtCompileTime
+		//
+		// (i): False if t is below the ITS_LOG_COMPILE_LEVEL threshold.
+		//
+		static constexpr bool IsEnabledAtCompileTime(ItsLogType t)
+		{
+			return (ItsLogUtil::LogTypeToLevel(t) >= ITS_LOG_COMPILE_LEVEL);
+		}
+
+		//
+		// Function: AppendArgument
+		//
+		// (i): Appends the text representation of a log argument.
+		//
+		template <typename T>
+		static void AppendArgument(string& text, const T& arg)
+		{
+			using A = std::decay_t<T>;
+			if constexpr (std::is_same_v<A, bool>)
+			{
+				text.append(arg ? "true" : "false");
+			}
+			else if constexpr (std::is_same_v<A, char>)
+			{
+				text.push_back(arg);
+			}
+			else if constexpr (std::is_floating_point_v<A>)
+			{
+				text.append(ItsConvert::ToString(static_cast<double>(arg)));
+			}
+			else if constexpr (std::is_integral_v<A>)
+			{
+				text.append(std::to_string(arg));
+			}
+			else
+			{
+				text.append(std::string_view(arg));
+			}
+		}
+
+		//
+		// Function: Format
+		//
+		// (i): Replaces each {} in format with the next argument.
+		//
+		template <typename... Args>
+		static string Format(std::string_view format, const Args&... args)
+		{
+			string text;
+			text.reserve(format.size() + 16 * sizeof...(Args));
+
+			auto appendNext = [&](const auto& arg) {
+				auto i = format.find("{}");
+				if (i == std::string_view::npos)
+				{
+					return;
+				}
+				text.append(format.substr(0, i));
+				ItsLogUtil::AppendArgument(text, arg);
+				format.remove_prefix(i + 2);
+			};
+			(appendNext(args), ...);
+
+			text.append(format);
+			return text;
+		}
+	};
+
+	//
+	// struct: ItsLogItem
+	//
+	// (i): Log item for ItsLog
+	//
+	struct ItsLogItem
+	{
+		ItsLogType Type;
+		string Description;
+		tm When;
+
+		string ToString() const
+		{
+			char when[ItsConvert::DateTimeBufferSize];
+			size_t whenLength = ItsConvert::ToString(this->When, 'T', when, sizeof(when));
+
+			string retVal;
+			retVal.reserve(48 + this->Description.size() * 2);
+			retVal.append("Type=");
+			retVal.append(ItsLogUtil::LogTypeToString(this->Type));
+			retVal.append(" When=");
+			retVal.append(when, whenLength);
+			retVal.append(" Description=");
+
+			// (i): Newlines are replaced by a space and ':' by " - ".
+			const string& d = this->Description;
+			for (size_t i = 0; i < d.size(); i++)
+			{
+				char c = d[i];
+				if (c == '\r' && i + 1 < d.size() && d[i + 1] == '\n')
+				{
+					retVal.push_back(' ');
+					i++;
+				}
+				else if (c == '\n')
+				{
+					retVal.push_back(' ');
+				}
+				else if (c == ':')
+				{
+					retVal.append(" - ");
+				}
+				else
+				{
+					retVal.push_back(c);
+				}
+			}
+
+			return retVal;
+		}
+	};
+
+	//
+	// enum: ItsLogOverflowPolicy
+	//
+	// (i): What an asynchronous ItsLog does when its queue is full.
+	//
+	enum class ItsLogOverflowPolicy
+	{
+		Drop,	// discard the item
+		Block,	// wait for the writer thread to make room
+		Count	// discard the item and log the number of discarded items
+	};
+
+	//
+	// struct: ItsLogRecord
+	//
+	// (i): Fixed size record passed from producers to the ItsLog writer thread.
+	//      Descriptions longer than TextCapacity are truncated.
+	//
+	struct ItsLogRecord
+	{
+		static constexpr size_t TextCapacity = 240;
+
+		time_t When;
+		ItsLogType Type;
+		uint16_t Length;
+		char Text[TextCapacity];
+	};
+
+	//
+	// class: ItsLogQueue
+	//
+	// (i): Bounded lock-free multi producer, single consumer queue of ItsLogRecord's.
+	//
+	class ItsLogQueue
+	{
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> Sequence;
+			ItsLogRecord Record;
+		};
+
+		std::unique_ptr<Cell[]> m_cells;
+		size_t m_mask;
+		alignas(64) std::atomic<size_t> m_enqueuePos{0};
+		alignas(64) size_t m_dequeuePos{0};
+
+	public:
+		explicit ItsLogQueue(size_t capacity)
+		{
+			size_t size = 2;
+			while (size < capacity)
+			{
+				size <<= 1;
+			}
+
+			this->m_cells = std::make_unique<Cell[]>(size);
+			this->m_mask = size - 1;
+			for (size_t i = 0; i < size; i++)
+			{
+				this->m_cells[i].Sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		ItsLogQueue(const ItsLogQueue&) = delete;
+		ItsLogQueue& operator=(const ItsLogQueue&) = delete;
+
+		size_t Capacity() const
+		{
+			return this->m_mask + 1;
+		}
+
+		//
+		// Method: TryPush
+		//
+		// (i): Called from any thread. Returns false if the queue is full.
+		//
+		bool TryPush(ItsLogType type, time_t when, const char* text, size_t length)
+		{
+			size_t pos = this->m_enqueuePos.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				Cell& cell = this->m_cells[pos & this->m_mask];
+				size_t seq = cell.Sequence.load(std::memory_order_acquire);
+				intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+				if (diff == 0)
+				{
+					if (this->m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					{
+						size_t n = (length > ItsLogRecord::TextCapacity) ? ItsLogRecord::TextCapacity : length;
+						cell.Record.When = when;
+						cell.Record.Type = type;
+						cell.Record.Length = static_cast<uint16_t>(n);
+						memcpy(cell.Record.Text, text, n);
+						cell.Sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0)
+				{
+					return false;
+				}
+				else
+				{
+					pos = this->m_enqueuePos.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		//
+		// Method: Drain
+		//
+		// (i): Called from the single consumer. Passes up to max records to fn.
+		//
+		template <typename F>
+		size_t Drain(F&& fn, size_t max)
+		{
+			size_t n = 0;
+			while (n < max)
+			{
+				Cell& cell = this->m_cells[this->m_dequeuePos & this->m_mask];
+				size_t seq = cell.Sequence.load(std::memory_order_acquire);
+				if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(this->m_dequeuePos + 1) < 0)
+				{
+					break;
+				}
+
+				fn(cell.Record);
+
+				cell.Sequence.store(this->m_dequeuePos + this->m_mask + 1, std::memory_order_release);
+				this->m_dequeuePos++;
+				n++;
+			}
+			return n;
+		}
+
+		size_t GetEnqueuePosition() const
+		{
+			return this->m_enqueuePos.load(std::memory_order_acquire);
+		}
+	};
+
+	//
+	// enum: ItsBinaryLogTag
+	//
+	// (i): Record and argument tags of the ItsBinaryLog file format.
+	//
+	//      File   : "ITSBLOG1" { Record }
+	//      Record : 'F' u16 id, u16 length, format bytes
+	//             | 'L' u8 type, u16 format id, i64 unix time ns, u16 length, { Argument }
+	//      Arg    : 'i' i64 | 'u' u64 | 'd' f64 | 'b' u8 | 'c' char | 's' u16 length, bytes
+	//      Formats use {} as argument placeholder. Numbers are little endian (host order).
+	//
+	enum class ItsBinaryLogTag : uint8_t
+	{
+		Format = 'F',
+		Log = 'L',
+		Int = 'i',
+		UInt = 'u',
+		Double = 'd',
+		Bool = 'b',
+		Char = 'c',
+		String = 's'
+	};
+
+	//
+	// class: ItsBinaryLogWriter
+	//
+	// (i): Writes log records as format id, raw timestamp and argument bytes.
+	//      Formatting is deferred to ItsBinaryLogReader.
+	//
+	class ItsBinaryLogWriter
+	{
+	public:
+		static constexpr char Magic[8] = {'I', 'T', 'S', 'B', 'L', 'O', 'G', '1'};
+		static constexpr uint16_t DescriptionFormatId = 0;
+		static constexpr size_t BufferSize = 64 * 1024;
+
+	private:
+		int m_fd{-1};
+		std::unique_ptr<uint8_t[]> m_buffer;
+		size_t m_size{0};
+		uint16_t m_formatCount{0};
+		std::deque<string> m_formatStore;
+		std::unordered_map<std::string_view, uint16_t> m_formatIds;
+		std::mutex m_lock;
+
+	protected:
+		template <typename T>
+		static void Put(uint8_t*& p, T value)
+		{
+			memcpy(p, &value, sizeof(T));
+			p += sizeof(T);
+		}
+
+		static void PutString(uint8_t*& p, const char* text, size_t length)
+		{
+			ItsBinaryLogWriter::Put<uint16_t>(p, static_cast<uint16_t>(length));
+			memcpy(p, text, length);
+			p += length;
+		}
+
+		static size_t StringLength(size_t length)
+		{
+			return (length > UINT16_MAX) ? UINT16_MAX : length;
+		}
+
+		template <typename T>
+		static size_t ArgSize(const T& arg)
+		{
+			using A = std::decay_t<T>;
+			if constexpr (std::is_same_v<A, bool> || std::is_same_v<A, char>)
+			{
+				return 2;
+			}
+			else if constexpr (std::is_arithmetic_v<A>)
+			{
+				return 9;
+			}
+			else
+			{
+				return 3 + ItsBinaryLogWriter::StringLength(std::string_view(arg).size());
+			}
+		}
+
+		template <typename T>
+		static void PutArg(uint8_t*& p, const T& arg)
+		{
+			using A = std::decay_t<T>;
+			if constexpr (std::is_same_v<A, bool>)
+			{
+				*p++ = static_cast<uint8_t>(ItsBinaryLogTag::Bool);
+				*p++ = arg ? 1 : 0;
+			}
+			else if constexpr (std::is_same_v<A, char>)
+			{
+				*p++ = static_cast<uint8_t>(ItsBinaryLogTag::Char);
+				*p++ = static_cast<uint8_t>(arg);
+			}
+			else if constexpr (std::is_floating_point_v<A>)
+			{
+				*p++ = static_cast<uint8_t>(ItsBinaryLogTag::Double);
+				ItsBinaryLogWriter::Put<double>(p, static_cast<double>(arg));
+			}
+			else if constexpr (std::is_integral_v<A> && std::is_signed_v<A>)
+			{
+				*p++ = static_cast<uint8_t>(ItsBinaryLogTag::Int);
+				ItsBinaryLogWriter::Put<int64_t>(p, static_cast<int64_t>(arg));
+			}
+			else if constexpr (std::is_integral_v<A>)
+			{
+				*p++ = static_cast<uint8_t>(ItsBinaryLogTag::UInt);
+				ItsBinaryLogWriter::Put<uint64_t>(p, static_cast<uint64_t>(arg));
+			}
+			else
+			{
+				std::string_view sv(arg);
+				*p++ = static_cast<uint8_t>(ItsBinaryLogTag::String);
+				ItsBinaryLogWriter::PutString(p, sv.data(), ItsBinaryLogWriter::StringLength(sv.size()));
+			}
+		}
+
+		// (i): m_lock must be held. Returns space for size bytes or nullptr.
+		uint8_t* Reserve(size_t size)
+		{
+			if (size > ItsBinaryLogWriter::BufferSize)
+			{
+				return nullptr;
+			}
+			if (this->m_size + size > ItsBinaryLogWriter::BufferSize)
+			{
+				this->FlushUnlocked();
+			}
+			uint8_t* p = this->m_buffer.get() + this->m_size;
+			this->m_size += size;
+			return p;
+		}
+
+		// (i): m_lock must be held.
+		void FlushUnlocked()
+		{
+			size_t offset = 0;
+			while (offset < this->m_size)
+			{
+				ssize_t n = ::write(this->m_fd, this->m_buffer.get() + offset, this->m_size - offset);
+				if (n <= 0)
+				{
+					if (n == -1 && errno == EINTR)
+					{
+						continue;
+					}
+					break;
+				}
+				offset += static_cast<size_t>(n);
+			}
+			this->m_size = 0;
+		}
+
+		// (i): m_lock must be held.
+		template <typename... Args>
+		bool WriteUnlocked(ItsLogType type, uint16_t formatId, const Args&... args)
+		{
+			if (this->m_fd == -1)
+			{
+				return false;
+			}
+
+			size_t argSize = (0 + ... + ItsBinaryLogWriter::ArgSize(args));
+			if (argSize > UINT16_MAX)
+			{
+				return false;
+			}
+
+			timespec ts;
+			clock_gettime(CLOCK_REALTIME, &ts);
+			int64_t when = static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+
+			uint8_t* p = this->Reserve(14 + argSize);
+			if (p == nullptr)
+			{
+				return false;
+			}
+			*p++ = static_cast<uint8_t>(ItsBinaryLogTag::Log);
+			*p++ = static_cast<uint8_t>(type);
+			ItsBinaryLogWriter::Put<uint16_t>(p, formatId);
+			ItsBinaryLogWriter::Put<int64_t>(p, when);
+			ItsBinaryLogWriter::Put<uint16_t>(p, static_cast<uint16_t>(argSize));
+			(ItsBinaryLogWriter::PutArg(p, args), ...);
+			return true;
+		}
+
+		// (i): m_lock must be held. Falls back to DescriptionFormatId when all
+		//      ids are used. Formats longer than a buffer are truncated.
+		uint16_t RegisterFormatUnlocked(std::string_view format)
+		{
+			if (this->m_formatCount == UINT16_MAX)
+			{
+				return ItsBinaryLogWriter::DescriptionFormatId;
+			}
+			size_t length = std::min(ItsBinaryLogWriter::StringLength(format.size()), ItsBinaryLogWriter::BufferSize - 5);
+			uint8_t* p = this->Reserve(5 + length);
+			if (p == nullptr)
+			{
+				return ItsBinaryLogWriter::DescriptionFormatId;
+			}
+			uint16_t id = this->m_formatCount++;
+			*p++ = static_cast<uint8_t>(ItsBinaryLogTag::Format);
+			ItsBinaryLogWriter::Put<uint16_t>(p, id);
+			ItsBinaryLogWriter::PutString(p, format.data(), length);
+			return id;
+		}
+
+	public:
+		ItsBinaryLogWriter()
+		:	m_buffer(std::make_unique<uint8_t[]>(ItsBinaryLogWriter::BufferSize))
+		{
+		}
+		~ItsBinaryLogWriter()
+		{
+			this->Close();
+		}
+		ItsBinaryLogWriter(const ItsBinaryLogWriter&) = delete;
+		ItsBinaryLogWriter& operator=(const ItsBinaryLogWriter&) = delete;
+
+		//
+		// Method: Open
+		//
+		// (i): Opens filename for append. Format 0 is always "{}".
+		//
+		bool Open(const string& filename)
+		{
+			if (this->IsOpen())
+			{
+				return false;
+			}
+
+			this->m_fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+			if (this->m_fd == -1)
+			{
+				return false;
+			}
+
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			if (::lseek(this->m_fd, 0, SEEK_END) == 0)
+			{
+				memcpy(this->Reserve(sizeof(Magic)), Magic, sizeof(Magic));
+			}
+			this->m_formatCount = 0;
+			this->m_formatIds.clear();
+			this->m_formatStore.clear();
+			this->RegisterFormatUnlocked("{}");
+			return true;
+		}
+
+		bool IsOpen()
+		{
+			return (this->m_fd != -1);
+		}
+
+		void Close()
+		{
+			if (this->m_fd != -1)
+			{
+				this->Flush();
+				::close(this->m_fd);
+				this->m_fd = -1;
+			}
+		}
+
+		//
+		// Method: RegisterFormat
+		//
+		// (i): Stores format in the file and returns its id.
+		//
+		uint16_t RegisterFormat(std::string_view format)
+		{
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			return this->RegisterFormatUnlocked(format);
+		}
+
+		//
+		// Method: Write
+		//
+		// (i): Appends a log record. Arguments may be arithmetic or convertible to string_view.
+		//
+		template <typename... Args>
+		bool Write(ItsLogType type, uint16_t formatId, const Args&... args)
+		{
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			return this->WriteUnlocked(type, formatId, args...);
+		}
+
+		//
+		// Method: WriteFormat
+		//
+		// (i): As Write. The format is registered on first use.
+		//
+		template <typename... Args>
+		bool WriteFormat(ItsLogType type, std::string_view format, const Args&... args)
+		{
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			if (this->m_fd == -1)
+			{
+				return false;
+			}
+
+			uint16_t formatId{0};
+			auto itr = this->m_formatIds.find(format);
+			if (itr != this->m_formatIds.end())
+			{
+				formatId = itr->second;
+			}
+			else
+			{
+				formatId = this->RegisterFormatUnlocked(format);
+				this->m_formatIds.emplace(std::string_view(this->m_formatStore.emplace_back(format)), formatId);
+			}
+			return this->WriteUnlocked(type, formatId, args...);
+		}
+
+		void Flush()
+		{
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			if (this->m_fd != -1)
+			{
+				this->FlushUnlocked();
+			}
+		}
+	};
+
+	//
+	// class: ItsBinaryLogReader
+	//
+	// (i): Reads and formats files written by ItsBinaryLogWriter.
+	//
+	class ItsBinaryLogReader
+	{
+	private:
+		int m_fd{-1};
+		vector<uint8_t> m_buffer;
+		size_t m_pos{0};
+		size_t m_end{0};
+		vector<string> m_formats;
+
+	protected:
+		// (i): Makes size bytes available at m_pos. False at end of file.
+		bool Ensure(size_t size)
+		{
+			if (this->m_end - this->m_pos >= size)
+			{
+				return true;
+			}
+
+			memmove(this->m_buffer.data(), this->m_buffer.data() + this->m_pos, this->m_end - this->m_pos);
+			this->m_end -= this->m_pos;
+			this->m_pos = 0;
+			if (this->m_buffer.size() < size)
+			{
+				this->m_buffer.resize(size);
+			}
+
+			while (this->m_end < size)
+			{
+				ssize_t n = ::read(this->m_fd, this->m_buffer.data() + this->m_end, this->m_buffer.size() - this->m_end);
+				if (n == -1 && errno == EINTR)
+				{
+					continue;
+				}
+				if (n <= 0)
+				{
+					return false;
+				}
+				this->m_end += static_cast<size_t>(n);
+			}
+			return true;
+		}
+
+		template <typename T>
+		static T Get(const uint8_t*& p)
+		{
+			T value;
+			memcpy(&value, p, sizeof(T));
+			p += sizeof(T);
+			return value;
+		}
+
+	public:
+		ItsBinaryLogReader()
+		:	m_buffer(ItsBinaryLogWriter::BufferSize)
+		{
+		}
+		~ItsBinaryLogReader()
+		{
+			this->Close();
+		}
+		ItsBinaryLogReader(const ItsBinaryLogReader&) = delete;
+		ItsBinaryLogReader& operator=(const ItsBinaryLogReader&) = delete;
+
+		bool Open(const string& filename)
+		{
+			if (this->m_fd != -1)
+			{
+				return false;
+			}
+
+			this->m_fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+			if (this->m_fd == -1)
+			{
+				return false;
+			}
+
+			this->m_pos = 0;
+			this->m_end = 0;
+			this->m_formats.clear();
+			if (!this->Ensure(sizeof(ItsBinaryLogWriter::Magic)) ||
+				memcmp(this->m_buffer.data(), ItsBinaryLogWriter::Magic, sizeof(ItsBinaryLogWriter::Magic)) != 0)
+			{
+				this->Close();
+				return false;
+			}
+			this->m_pos += sizeof(ItsBinaryLogWriter::Magic);
+			return true;
+		}
+
+		void Close()
+		{
+			if (this->m_fd != -1)
+			{
+				::close(this->m_fd);
+				this->m_fd = -1;
+			}
+		}
+
+		//
+		// Method: Next
+		//
+		// (i): Reads and formats the next log record. False at end of file or on corrupt data.
+		//
+		bool Next(ItsLogItem& item)
+		{
+			int64_t when{0};
+			return this->Next(item, &when);
+		}
+
+		bool Next(ItsLogItem& item, int64_t* nanoseconds)
+		{
+			while (this->m_fd != -1 && this->Ensure(1))
+			{
+				auto tag = static_cast<ItsBinaryLogTag>(this->m_buffer[this->m_pos]);
+				if (tag == ItsBinaryLogTag::Format)
+				{
+					if (!this->Ensure(5))
+					{
+						return false;
+					}
+					const uint8_t* p = this->m_buffer.data() + this->m_pos + 1;
+					uint16_t id = ItsBinaryLogReader::Get<uint16_t>(p);
+					uint16_t length = ItsBinaryLogReader::Get<uint16_t>(p);
+					if (!this->Ensure(5 + length))
+					{
+						return false;
+					}
+					p = this->m_buffer.data() + this->m_pos + 5;
+					if (this->m_formats.size() <= id)
+					{
+						this->m_formats.resize(id + 1);
+					}
+					this->m_formats[id].assign(reinterpret_cast<const char*>(p), length);
+					this->m_pos += 5 + length;
+				}
+				else if (tag == ItsBinaryLogTag::Log)
+				{
+					if (!this->Ensure(14))
+					{
+						return false;
+					}
+					const uint8_t* p = this->m_buffer.data() + this->m_pos + 1;
+					auto type = static_cast<ItsLogType>(*p++);
+					uint16_t formatId = ItsBinaryLogReader::Get<uint16_t>(p);
+					int64_t when = ItsBinaryLogReader::Get<int64_t>(p);
+					uint16_t length = ItsBinaryLogReader::Get<uint16_t>(p);
+					if (!this->Ensure(14 + length))
+					{
+						return false;
+					}
+					p = this->m_buffer.data() + this->m_pos + 14;
+
+					std::string_view format = (formatId < this->m_formats.size()) ? std::string_view(this->m_formats[formatId]) : std::string_view("{}");
+					item.Type = type;
+					item.Description = ItsBinaryLogReader::Format(format, p, length);
+					time_t seconds = static_cast<time_t>(when / 1000000000);
+					ItsClock::ToLocalTime(seconds, &item.When);
+					*nanoseconds = when;
+
+					this->m_pos += 14 + length;
+					return true;
+				}
+				else
+				{
+					return false;
+				}
+			}
+			return false;
+		}
+
+		//
+		// Function: Format
+		//
+		// (i): Replaces each {} in format with the next encoded argument.
+		//      Arguments cut short by corrupt data are shown as {?}.
+		//
+		static string Format(std::string_view format, const uint8_t* args, size_t size)
+		{
+			string result;
+			result.reserve(format.size() + size);
+
+			const uint8_t* p = args;
+			const uint8_t* end = args + size;
+			size_t i = 0;
+			while (i < format.size())
+			{
+				if (format[i] != '{' || i + 1 >= format.size() || format[i + 1] != '}')
+				{
+					result.push_back(format[i++]);
+					continue;
+				}
+				i += 2;
+
+				if (p >= end)
+				{
+					result.append("{}");
+					continue;
+				}
+
+				auto tag = static_cast<ItsBinaryLogTag>(*p++);
+				size_t available = static_cast<size_t>(end - p);
+				size_t needed = 0;
+				switch (tag)
+				{
+				case ItsBinaryLogTag::Int:
+				case ItsBinaryLogTag::UInt:
+				case ItsBinaryLogTag::Double:
+					needed = 8;
+					break;
+				case ItsBinaryLogTag::Bool:
+				case ItsBinaryLogTag::Char:
+					needed = 1;
+					break;
+				case ItsBinaryLogTag::String:
+					if (available >= 2)
+					{
+						const uint8_t* q = p;
+						needed = 2 + ItsBinaryLogReader::Get<uint16_t>(q);
+					}
+					else
+					{
+						needed = 2;
+					}
+					break;
+				default:
+					needed = SIZE_MAX;
+					break;
+				}
+				if (needed > available)
+				{
+					p = end;
+					result.append("{?}");
+					continue;
+				}
+
+				switch (tag)
+				{
+				case ItsBinaryLogTag::Int:
+					result.append(std::to_string(ItsBinaryLogReader::Get<int64_t>(p)));
+					break;
+				case ItsBinaryLogTag::UInt:
+					result.append(std::to_string(ItsBinaryLogReader::Get<uint64_t>(p)));
+					break;
+				case ItsBinaryLogTag::Double:
+					result.append(ItsConvert::ToString(ItsBinaryLogReader::Get<double>(p)));
+					break;
+				case ItsBinaryLogTag::Bool:
+					result.append((*p++ != 0) ? "true" : "false");
+					break;
+				case ItsBinaryLogTag::Char:
+					result.push_back(static_cast<char>(*p++));
+					break;
+				case ItsBinaryLogTag::String:
+					{
+						uint16_t length = ItsBinaryLogReader::Get<uint16_t>(p);
+						result.append(reinterpret_cast<const char*>(p), length);
+						p += length;
+					}
+					break;
+				default:
+					break;
+				}
+			}
+			return result;
+		}
+	};
+
+	//
+	// class: ItsLogFileSink
+	//
+	// (i): Log file with size and time based rotation. Writes are batched in memory,
+	//      files are preallocated with fallocate and rotated segments are compressed
+	//      with gzip on a low priority background thread.
+	//
+	class ItsLogFileSink
+	{
+	public:
+		static constexpr size_t BufferSize = 256 * 1024;
+
+	private:
+		string m_filename;
+		size_t m_maxFileSize;
+		time_t m_maxAge;
+		bool m_bCompress;
+		int m_fd{-1};
+		size_t m_fileSize{0};
+		time_t m_opened{0};
+		uint32_t m_rotation{0};
+		std::unique_ptr<char[]> m_buffer;
+		size_t m_size{0};
+		std::mutex m_lock;
+
+		std::thread m_compressor;
+		std::deque<string> m_compressQueue;
+		bool m_bStopCompressor{false};
+		std::mutex m_compressLock;
+		std::condition_variable m_compressSignal;
+		std::atomic<uint32_t> m_compressErrors{0};
+
+	protected:
+		// (i): m_lock must be held.
+		bool OpenFile()
 		{
-			this->m_tm.tm_hour -= hour;
+			this->m_fd = ::open(this->m_filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+			if (this->m_fd == -1)
+			{
+				return false;
+			}
 
-			mktime(&this->m_tm);
+			struct stat st;
+			this->m_fileSize = (fstat(this->m_fd, &st) == 0) ? static_cast<size_t>(st.st_size) : 0;
+			this->m_opened = time(nullptr);
+
+			if (this->m_maxFileSize > 0 && this->m_fileSize < this->m_maxFileSize)
+			{
+				fallocate(this->m_fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(this->m_maxFileSize));
+			}
+			return true;
 		}
 
-		void SubtractMinutes(int min)
+		// (i): m_lock must be held.
+		void FlushUnlocked()
 		{
-			this->m_tm.tm_min -= min;
+			size_t offset = 0;
+			while (offset < this->m_size && this->m_fd != -1)
+			{
+				ssize_t n = ::write(this->m_fd, this->m_buffer.get() + offset, this->m_size - offset);
+				if (n <= 0)
+				{
+					if (n == -1 && errno == EINTR)
+					{
+						continue;
+					}
+					break;
+				}
+				offset += static_cast<size_t>(n);
+			}
+			this->m_fileSize += offset;
+			this->m_size = 0;
+		}
 
-			mktime(&this->m_tm);
+		// (i): m_lock must be held.
+		bool IsRotationDue(size_t pending)
+		{
+			if (this->m_maxFileSize > 0 && this->m_fileSize + this->m_size + pending > this->m_maxFileSize && (this->m_fileSize + this->m_size) > 0)
+			{
+				return true;
+			}
+			if (this->m_maxAge > 0 && (time(nullptr) - this->m_opened) >= this->m_maxAge && (this->m_fileSize + this->m_size) > 0)
+			{
+				return true;
+			}
+			return false;
 		}
 
-		void SubtractSeconds(int sec)
+		// (i): m_lock must be held.
+		void Rotate()
 		{
-			this->m_tm.tm_sec -= sec;
+			this->FlushUnlocked();
+			if (this->m_fd != -1)
+			{
+				ftruncate(this->m_fd, static_cast<off_t>(this->m_fileSize));
+				::close(this->m_fd);
+				this->m_fd = -1;
+			}
 
-			mktime(&this->m_tm);
+			time_t now = time(nullptr);
+			tm t;
+			localtime_r(&now, &t);
+			char suffix[64];
+			snprintf(suffix, sizeof(suffix), ".%04d%02d%02d-%02d%02d%02d.%u", t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+					 t.tm_hour, t.tm_min, t.tm_sec, this->m_rotation++);
+			string rotated = this->m_filename + suffix;
+
+			if (::rename(this->m_filename.c_str(), rotated.c_str()) == 0 && this->m_bCompress)
+			{
+				std::lock_guard<std::mutex> lock(this->m_compressLock);
+				this->m_compressQueue.push_back(rotated);
+				if (!this->m_compressor.joinable())
+				{
+					this->m_compressor = std::thread(&ItsLogFileSink::ExecuteCompressorThread, this);
+				}
+				this->m_compressSignal.notify_one();
+			}
+
+			this->OpenFile();
 		}
 
-		void Subtract(int year, int month, int day, int hour, int min, int sec)
+		void ExecuteCompressorThread()
 		{
-			this->m_tm.tm_year -= year;
-			this->m_tm.tm_mon -= month;
-			this->m_tm.tm_mday -= day;
-			this->m_tm.tm_hour -= hour;
-			this->m_tm.tm_min -= min;
-			this->m_tm.tm_sec -= sec;
+			setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
 
-			mktime(&this->m_tm);
+			std::unique_lock<std::mutex> lock(this->m_compressLock);
+			for (;;)
+			{
+				this->m_compressSignal.wait(lock, [this]() { return this->m_bStopCompressor || !this->m_compressQueue.empty(); });
+				if (this->m_compressQueue.empty())
+				{
+					break;
+				}
+
+				string path = std::move(this->m_compressQueue.front());
+				this->m_compressQueue.pop_front();
+
+				lock.unlock();
+				if (!ItsLogFileSink::Compress(path))
+				{
+					this->m_compressErrors.fetch_add(1, std::memory_order_relaxed);
+				}
+				lock.lock();
+			}
 		}
 
-		int GetYear()
+		//
+		// Function: Compress
+		//
+		// (i): Runs gzip on path with posix_spawnp, which is safe in a multithreaded
+		//      process. The child inherits the low priority of the calling thread.
+		//      False if gzip could not be started or did not exit with 0.
+		//
+		static bool Compress(const string& path)
 		{
-			return this->m_tm.tm_year + 1900;
+			string file = path;
+			char gzip[] = "gzip";
+			char force[] = "-f";
+			char quiet[] = "-q";
+			char* argv[] = {gzip, force, quiet, file.data(), nullptr};
+
+			pid_t pid{0};
+			if (posix_spawnp(&pid, "gzip", nullptr, nullptr, argv, environ) != 0)
+			{
+				return false;
+			}
+
+			int status{0};
+			while (waitpid(pid, &status, 0) == -1)
+			{
+				if (errno != EINTR)
+				{
+					return false;
+				}
+			}
+			return (WIFEXITED(status) && WEXITSTATUS(status) == 0);
 		}
 
-		int GetMonth()
+	public:
+		//
+		// Method: Constructor
+		//
+		// (i): maxFileSize in bytes and maxAgeSeconds, 0 disables that rotation trigger.
+		//
+		ItsLogFileSink(const string& filename, size_t maxFileSize, uint32_t maxAgeSeconds, bool compress)
+		:	m_filename(filename),
+			m_maxFileSize(maxFileSize),
+			m_maxAge(static_cast<time_t>(maxAgeSeconds)),
+			m_bCompress(compress),
+			m_buffer(std::make_unique<char[]>(ItsLogFileSink::BufferSize))
 		{
-			return this->m_tm.tm_mon + 1;
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			this->OpenFile();
+		}
+		~ItsLogFileSink()
+		{
+			{
+				std::lock_guard<std::mutex> lock(this->m_lock);
+				this->FlushUnlocked();
+				if (this->m_fd != -1)
+				{
+					ftruncate(this->m_fd, static_cast<off_t>(this->m_fileSize));
+					::close(this->m_fd);
+					this->m_fd = -1;
+				}
+			}
+			{
+				std::lock_guard<std::mutex> lock(this->m_compressLock);
+				this->m_bStopCompressor = true;
+			}
+			this->m_compressSignal.notify_one();
+			if (this->m_compressor.joinable())
+			{
+				this->m_compressor.join();
+			}
 		}
+		ItsLogFileSink(const ItsLogFileSink&) = delete;
+		ItsLogFileSink& operator=(const ItsLogFileSink&) = delete;
 
-		int GetDay()
+		bool IsValid()
 		{
-			return this->m_tm.tm_mday;
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			return (this->m_fd != -1);
 		}
 
-		int GetHour()
+		//
+		// Method: WriteLine
+		//
+		// (i): Appends line and a newline to the batch buffer.
+		//
+		void WriteLine(std::string_view line)
 		{
-			return this->m_tm.tm_hour;
+			std::lock_guard<std::mutex> lock(this->m_lock);
+
+			size_t size = line.size() + 1;
+			if (this->IsRotationDue(size))
+			{
+				this->Rotate();
+			}
+			if (this->m_size + size > ItsLogFileSink::BufferSize)
+			{
+				this->FlushUnlocked();
+			}
+			if (size > ItsLogFileSink::BufferSize)
+			{
+				line = line.substr(0, ItsLogFileSink::BufferSize - 1);
+				size = ItsLogFileSink::BufferSize;
+			}
+
+			memcpy(this->m_buffer.get() + this->m_size, line.data(), line.size());
+			this->m_buffer[this->m_size + line.size()] = '\n';
+			this->m_size += size;
 		}
 
-		int GetMinute()
+		void Flush()
 		{
-			return this->m_tm.tm_min;
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			this->FlushUnlocked();
 		}
 
-		int GetSecond()
+		//
+		// Method: GetCompressErrors
+		//
+		// (i): Rotated segments that could not be compressed, e.g. gzip missing.
+		//      Such segments are kept uncompressed.
+		//
+		uint32_t GetCompressErrors()
 		{
-			return this->m_tm.tm_sec;
+			return this->m_compressErrors.load(std::memory_order_relaxed);
 		}
 
-		ItsDateTime &operator=(const tm &timeDate)
+		//
+		// Method: ForceRotate
+		//
+		// (i): Forces a rotation, e.g. on SIGHUP.
+		//
+		void ForceRotate()
 		{
-			this->m_tm = timeDate;
-			return *this;
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			this->Rotate();
 		}
 	};
 
 	//
-	// Function: ItsRandom
+	// struct: ItsLog
 	//
-	// (i): A random number wrapper.
+	// (i): CUstom application event log.
+	//      Keeps all items in memory unless a retention capacity is set, in which case
+	//      the newest items are kept in a ring and evicted items may spill to a file.
+	//      In asynchronous mode producers only copy a fixed size record into a lock-free
+	//      queue. A background thread formats and writes the records in batches.
 	//
-	template <typename Numeric, typename Generator = std::mt19937>
-	Numeric ItsRandom(Numeric from, Numeric to)
+	struct ItsLog
 	{
-		thread_local static Generator gen(std::random_device{}());
+	private:
+		static constexpr size_t WriterBatchSize = 256;
 
-		using dist_type = typename std::conditional<
-			std::is_integral<Numeric>::value, std::uniform_int_distribution<Numeric>, std::uniform_real_distribution<Numeric>>::type;
+		vector<ItsLogItem> m_items;
+		std::unique_ptr<ItsBinaryLogWriter> m_binaryOwner;
+		std::atomic<ItsBinaryLogWriter*> m_binary{nullptr};  // set once by OpenBinaryLog, never replaced
+		std::unique_ptr<ItsLogFileSink> m_fileSink;
+		size_t m_capacity{0};
+		size_t m_head{0};
+		FILE* m_spillFile{nullptr};
+		string m_ident;
+		bool m_bLogToSyslog;
+		bool m_bAsync{false};
+		ItsLogOverflowPolicy m_overflowPolicy{ItsLogOverflowPolicy::Drop};
+		std::unique_ptr<ItsLogQueue> m_queue;
+		std::thread m_writer;
+		std::atomic<bool> m_bStopWriter{false};
+		std::atomic<uint64_t> m_dropped{0};
+		std::atomic<size_t> m_consumed{0};
+		uint64_t m_droppedReported{0};
+		std::chrono::milliseconds m_flushInterval{5};
+		std::atomic<int> m_minimumLevel{0};
+		std::mutex m_lock;
+		std::mutex m_writerLock;
+		std::condition_variable m_writerSignal;
+		std::condition_variable m_flushSignal;
+
+	protected:
+		// (i): m_lock must be held.
+		void Write(ItsLogItem&& item)
+		{
+			if ( this->m_bLogToSyslog || this->m_fileSink != nullptr ) {
+				auto text = item.ToString();
+				if ( this->m_bLogToSyslog ) {
+					syslog(ItsLogUtil::LogTypeToSyslogPriority(item.Type), "%s", text.c_str());
+				}
+				if ( this->m_fileSink != nullptr ) {
+					this->m_fileSink->WriteLine(text);
+				}
+			}
 
-		thread_local static dist_type dist;
+			if (this->m_capacity == 0 || this->m_items.size() < this->m_capacity)
+			{
+				this->m_items.push_back(std::move(item));
+				return;
+			}
 
-		return dist(gen, typename dist_type::param_type{from, to});
-	}
+			auto& oldest = this->m_items[this->m_head];
+			this->Spill(oldest);
+			oldest = std::move(item);
+			this->m_head = (this->m_head + 1) % this->m_capacity;
+		}
 
-	//
-	// forward declare
-	//
-	struct ItsLog;
+		// (i): m_lock must be held.
+		void Spill(const ItsLogItem& item)
+		{
+			if (this->m_spillFile != nullptr)
+			{
+				auto line = item.ToString();
+				line.push_back('\n');
+				fwrite(line.data(), 1, line.size(), this->m_spillFile);
+			}
+		}
 
-	//
-	// ItsLogType
-	//
-	// (i): Log type for ItsLogItem
-	//
-	enum class ItsLogType
-	{
-		Information,
-		Warning,
-		Error,
-		Other,
-		Debug
-	};
+		// (i): m_lock must be held. Index 0 is the oldest item.
+		const ItsLogItem& ItemAt(size_t index)
+		{
+			size_t i = this->m_head + index;
+			if (i >= this->m_items.size())
+			{
+				i -= this->m_items.size();
+			}
+			return this->m_items[i];
+		}
 
-	//
-	// ItsLogUtil
-	//
-	// (i): Convertion misc. methods.
-	//
-	struct ItsLogUtil
-	{
-		static constexpr const char* LogTypeToString(ItsLogType t)
+		// (i): m_lock must be held. Rotates ring storage into chronological order.
+		void Linearize()
 		{
-			switch (t)
+			if (this->m_head != 0)
 			{
-			case ItsLogType::Information:
-				return "Information";
-				break;
-			case ItsLogType::Warning:
-				return "Warning";
-				break;
-			case ItsLogType::Error:
-				return "Error";
-				break;
-			case ItsLogType::Other:
-				return "Other";
-				break;
-			case ItsLogType::Debug:
-				return "Debug";
-				break;
-			default:
-				break;
+				std::rotate(this->m_items.begin(), this->m_items.begin() + this->m_head, this->m_items.end());
+				this->m_head = 0;
 			}
-			return "Unknown";
 		}
-	};
 
-	//
-	// struct: ItsLogItem
-	//
-	// (i): Log item for ItsLog
-	//
-	struct ItsLogItem
-	{
-		ItsLogType Type;
-		string Description;
-		tm When;
+		ItsBinaryLogWriter* GetBinary() const
+		{
+			return this->m_binary.load(std::memory_order_acquire);
+		}
 
-		string ToString()
+		void Append(ItsLogType type, const string& description)
 		{
-			stringstream ss;
-			string nl1("\r\n");
-			string nl2("\n");
-			string s1(":");
-			string rep_nl(" ");
-			string rep_s(" - ");
-			
-			auto description = ItsString::Replace(this->Description, nl1, rep_nl);
-			description = ItsString::Replace(description, nl2, rep_nl);
-			description = ItsString::Replace(description, s1, rep_s);
-			ss << "Type=" << ItsLogUtil::LogTypeToString(this->Type) << " " << "When=" << ItsDateTime(this->When).ToString("s") << " " << "Description=" << description;
+			if (!this->IsEnabled(type))
+			{
+				return;
+			}
+
+			if (auto binary = this->GetBinary(); binary != nullptr)
+			{
+				binary->Write(type, ItsBinaryLogWriter::DescriptionFormatId, description);
+				return;
+			}
+
+			if (this->m_bAsync)
+			{
+				this->Enqueue(type, description);
+				return;
+			}
+
+			ItsLogItem item;
+			item.When = ItsClock::Now();
+			item.Description = description;
+			item.Type = type;
+
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			this->Write(std::move(item));
+		}
+
+		void Enqueue(ItsLogType type, const string& description)
+		{
+			time_t when = ItsClock::Seconds();
+			while (!this->m_queue->TryPush(type, when, description.data(), description.size()))
+			{
+				if (this->m_overflowPolicy != ItsLogOverflowPolicy::Block)
+				{
+					this->m_dropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+
+				this->m_writerSignal.notify_one();
+				std::this_thread::yield();
+			}
+		}
+
+		void ExecuteWriterThread()
+		{
+			vector<ItsLogItem> batch;
+			batch.reserve(ItsLog::WriterBatchSize);
+
+			for (;;)
+			{
+				batch.clear();
+				size_t n = this->m_queue->Drain([&batch](const ItsLogRecord& record) {
+					ItsLogItem item;
+					ItsClock::ToLocalTime(record.When, &item.When);
+					item.Description.assign(record.Text, record.Length);
+					item.Type = record.Type;
+					batch.push_back(std::move(item));
+				}, ItsLog::WriterBatchSize);
+
+				if (n > 0)
+				{
+					{
+						std::lock_guard<std::mutex> lock(this->m_lock);
+						for (auto& item : batch)
+						{
+							this->Write(std::move(item));
+						}
+					}
+					this->m_consumed.fetch_add(n, std::memory_order_release);
+					{
+						std::lock_guard<std::mutex> lock(this->m_writerLock);
+					}
+					this->m_flushSignal.notify_all();
+					continue;
+				}
+
+				this->WriteDroppedCount();
+
+				if (this->m_bStopWriter.load(std::memory_order_acquire))
+				{
+					break;
+				}
+
+				std::unique_lock<std::mutex> lock(this->m_writerLock);
+				this->m_writerSignal.wait_for(lock, this->m_flushInterval);
+			}
+		}
+
+		void WriteDroppedCount()
+		{
+			if (this->m_overflowPolicy != ItsLogOverflowPolicy::Count)
+			{
+				return;
+			}
+
+			uint64_t dropped = this->m_dropped.load(std::memory_order_relaxed);
+			if (dropped == this->m_droppedReported)
+			{
+				return;
+			}
+
+			ItsLogItem item;
+			item.When = ItsClock::Now();
+			item.Description = "ItsLog dropped ";
+			item.Description += std::to_string(dropped - this->m_droppedReported);
+			item.Description += " log item(s), queue full";
+			item.Type = ItsLogType::Warning;
+			this->m_droppedReported = dropped;
 
-			string retVal = ss.str();
-			return retVal;
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			this->Write(std::move(item));
 		}
-	};
 
-	//
-	// struct: ItsLog
-	//
-	// (i): CUstom application event log.
-	//
-	struct ItsLog
-	{
-	private:
-		vector<ItsLogItem> m_items;
-		string m_ident;
-		bool m_bLogToSyslog;
 	public:
 		ItsLog(const string& ident, bool log_to_syslog)
 		:	m_ident(ident),
@@ -1395,103 +6624,365 @@ namespace ItSoftware::Linux
 				openlog(this->m_ident.c_str(), LOG_NDELAY|LOG_NOWAIT|LOG_PID,0);
 			}
 		}
+		//
+		// Method: Constructor
+		//
+		// (i): Asynchronous log. capacity is rounded up to a power of two.
+		//
+		ItsLog(const string& ident, bool log_to_syslog, size_t capacity, ItsLogOverflowPolicy policy)
+		:	ItsLog(ident, log_to_syslog)
+		{
+			this->m_bAsync = true;
+			this->m_overflowPolicy = policy;
+			this->m_queue = std::make_unique<ItsLogQueue>(capacity);
+			this->m_writer = std::thread(&ItsLog::ExecuteWriterThread, this);
+		}
 		~ItsLog()
 		{
+			if (this->m_bAsync) {
+				this->m_bStopWriter.store(true, std::memory_order_release);
+				this->m_writerSignal.notify_one();
+				if (this->m_writer.joinable()) {
+					this->m_writer.join();
+				}
+			}
 			if (this->m_bLogToSyslog) {
 				closelog();
 			}
+			if (this->m_spillFile != nullptr) {
+				fclose(this->m_spillFile);
+			}
 		}
+		ItsLog(const ItsLog&) = delete;
+		ItsLog& operator=(const ItsLog&) = delete;
+
 		void LogInformation(const string& description)
 		{
-			ItsLogItem item;
-			item.When = ItsDateTime::Now().TM();
-			item.Description = description;
-			item.Type = ItsLogType::Information;
+			if constexpr (ItsLogUtil::IsEnabledAtCompileTime(ItsLogType::Information))
+			{
+				this->Append(ItsLogType::Information, description);
+			}
+		}
 
-			this->m_items.push_back(item);
+		void LogWarning(const string& description)
+		{
+			if constexpr (ItsLogUtil::IsEnabledAtCompileTime(ItsLogType::Warning))
+			{
+				this->Append(ItsLogType::Warning, description);
+			}
+		}
 
-			if ( this->m_bLogToSyslog ) {
-				syslog(LOG_INFO, "%s", item.ToString().c_str());
+		void LogError(const string& description)
+		{
+			if constexpr (ItsLogUtil::IsEnabledAtCompileTime(ItsLogType::Error))
+			{
+				this->Append(ItsLogType::Error, description);
 			}
 		}
 
-		void LogWarning(const string& description)
+		void LogOther(const string& description)
 		{
-			ItsLogItem item;
-			item.When = ItsDateTime::Now().TM();
-			item.Description = description;
-			item.Type = ItsLogType::Warning;
+			if constexpr (ItsLogUtil::IsEnabledAtCompileTime(ItsLogType::Other))
+			{
+				this->Append(ItsLogType::Other, description);
+			}
+		}
 
-			this->m_items.push_back(item);
+		void LogDebug(const string& description)
+		{
+			if constexpr (ItsLogUtil::IsEnabledAtCompileTime(ItsLogType::Debug))
+			{
+				this->Append(ItsLogType::Debug, description);
+			}
+		}
 
-			if ( this->m_bLogToSyslog ) {
-				syslog(LOG_INFO, "%s", item.ToString().c_str());
+		//
+		// Method: Log
+		//
+		// (i): Lazy logging. make() is only called if Type is enabled.
+		//      Compiles away below ITS_LOG_COMPILE_LEVEL.
+		//
+		template <ItsLogType Type, typename F, typename = std::enable_if_t<std::is_invocable_v<F>>>
+		void Log(F&& make)
+		{
+			if constexpr (ItsLogUtil::IsEnabledAtCompileTime(Type))
+			{
+				if (this->IsEnabled(Type))
+				{
+					this->Append(Type, make());
+				}
 			}
 		}
 
-		void LogError(const string& description)
+		//
+		// Method: Log
+		//
+		// (i): Logs format with each {} replaced by the next argument. Formatting only
+		//      happens if Type is enabled; in binary mode the arguments are recorded raw.
+		//
+		template <ItsLogType Type, typename... Args>
+		void Log(std::string_view format, const Args&... args)
 		{
-			ItsLogItem item;
-			item.When = ItsDateTime::Now().TM();
-			item.Description = description;
-			item.Type = ItsLogType::Error;
+			if constexpr (ItsLogUtil::IsEnabledAtCompileTime(Type))
+			{
+				if (!this->IsEnabled(Type))
+				{
+					return;
+				}
+				if (auto binary = this->GetBinary(); binary != nullptr)
+				{
+					binary->WriteFormat(Type, format, args...);
+					return;
+				}
+				this->Append(Type, ItsLogUtil::Format(format, args...));
+			}
+		}
+
+		//
+		// Method: SetMinimumLevel
+		//
+		// (i): Items with a lower level than type are discarded before any work is done.
+		//
+		void SetMinimumLevel(ItsLogType type)
+		{
+			this->m_minimumLevel.store(ItsLogUtil::LogTypeToLevel(type), std::memory_order_relaxed);
+		}
 
-			this->m_items.push_back(item);
+		bool IsEnabled(ItsLogType type) const
+		{
+			return (ItsLogUtil::LogTypeToLevel(type) >= this->m_minimumLevel.load(std::memory_order_relaxed));
+		}
 
-			if ( this->m_bLogToSyslog ) {
-				syslog(LOG_INFO, "%s", item.ToString().c_str());
+		//
+		// Method: OpenFileSink
+		//
+		// (i): Also writes items to a rotating log file, see ItsLogFileSink.
+		//
+		bool OpenFileSink(const string& filename, size_t maxFileSize, uint32_t maxAgeSeconds, bool compress)
+		{
+			auto sink = std::make_unique<ItsLogFileSink>(filename, maxFileSize, maxAgeSeconds, compress);
+			if (!sink->IsValid())
+			{
+				return false;
 			}
+
+			this->Flush();
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			this->m_fileSink = std::move(sink);
+			return true;
 		}
 
-		void LogOther(const string& description)
+		//
+		// Method: OpenBinaryLog
+		//
+		// (i): Binary mode. Items are written as records to filename only, see
+		//      ItsBinaryLogWriter. They are not kept in memory or sent to syslog.
+		//      Succeeds once per ItsLog: returns false if a binary log is already
+		//      open, since threads may be writing to it. Call before logging starts;
+		//      items logged earlier stay in text mode.
+		//
+		bool OpenBinaryLog(const string& filename)
 		{
-			ItsLogItem item;
-			item.When = ItsDateTime::Now().TM();
-			item.Description = description;
-			item.Type = ItsLogType::Other;
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			if (this->m_binaryOwner != nullptr)
+			{
+				return false;
+			}
+			auto binary = std::make_unique<ItsBinaryLogWriter>();
+			if (!binary->Open(filename))
+			{
+				return false;
+			}
+			this->m_binaryOwner = std::move(binary);
+			this->m_binary.store(this->m_binaryOwner.get(), std::memory_order_release);
+			return true;
+		}
 
-			this->m_items.push_back(item);
+		bool IsBinary()
+		{
+			return (this->GetBinary() != nullptr);
+		}
 
-			if ( this->m_bLogToSyslog ) {
-				syslog(LOG_INFO, "%s", item.ToString().c_str());
+		//
+		// Method: RegisterFormat
+		//
+		// (i): Registers a {} placeholder format for LogFormat. Binary mode only.
+		//
+		uint16_t RegisterFormat(std::string_view format)
+		{
+			auto binary = this->GetBinary();
+			if (binary == nullptr)
+			{
+				return ItsBinaryLogWriter::DescriptionFormatId;
 			}
+			return binary->RegisterFormat(format);
 		}
 
-		void LogDebug(const string& description)
+		//
+		// Method: LogFormat
+		//
+		// (i): Records format id and raw arguments. Binary mode only.
+		//
+		template <typename... Args>
+		bool LogFormat(ItsLogType type, uint16_t formatId, const Args&... args)
 		{
-			ItsLogItem item;
-			item.When = ItsDateTime::Now().TM();
-			item.Description = description;
-			item.Type = ItsLogType::Debug;
+			auto binary = this->GetBinary();
+			if (binary == nullptr || !this->IsEnabled(type))
+			{
+				return false;
+			}
+			return binary->Write(type, formatId, args...);
+		}
+
+		//
+		// Method: Flush
+		//
+		// (i): Waits until all items queued so far are written and flushes binary log and file sink.
+		//
+		void Flush()
+		{
+			if (auto binary = this->GetBinary(); binary != nullptr) {
+				binary->Flush();
+			}
+
+			if (this->m_bAsync) {
+				size_t target = this->m_queue->GetEnqueuePosition();
+				std::unique_lock<std::mutex> lock(this->m_writerLock);
+				while (this->m_consumed.load(std::memory_order_acquire) < target)
+				{
+					this->m_writerSignal.notify_one();
+					this->m_flushSignal.wait_for(lock, this->m_flushInterval);
+				}
+			}
 
-			this->m_items.push_back(item);
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			if (this->m_fileSink != nullptr) {
+				this->m_fileSink->Flush();
+			}
+		}
+
+		bool IsAsync()
+		{
+			return this->m_bAsync;
+		}
+
+		//
+		// Method: SetRetention
+		//
+		// (i): Keep at most capacity items in memory. 0 keeps all items.
+		//      Items evicted from the ring are appended to spillFilename if given.
+		//      Returns false, with retention and spill file unchanged, if
+		//      spillFilename cannot be opened.
+		//
+		bool SetRetention(size_t capacity)
+		{
+			return this->SetRetention(capacity, string(""));
+		}
+
+		bool SetRetention(size_t capacity, const string& spillFilename)
+		{
+			this->Flush();
+			std::lock_guard<std::mutex> lock(this->m_lock);
+
+			// Open the new spill file first so a failure leaves the current setup intact.
+			FILE* spillFile = nullptr;
+			if (spillFilename.size() > 0)
+			{
+				spillFile = fopen(spillFilename.c_str(), "a");
+				if (spillFile == nullptr)
+				{
+					return false;
+				}
+			}
+			if (this->m_spillFile != nullptr)
+			{
+				fclose(this->m_spillFile);
+			}
+			this->m_spillFile = spillFile;
 
-			if ( this->m_bLogToSyslog ) {
-				syslog(LOG_INFO, "%s", item.ToString().c_str());
+			this->Linearize();
+			if (capacity > 0 && this->m_items.size() > capacity)
+			{
+				size_t evict = this->m_items.size() - capacity;
+				for (size_t i = 0; i < evict; i++)
+				{
+					this->Spill(this->m_items[i]);
+				}
+				this->m_items.erase(this->m_items.begin(), this->m_items.begin() + evict);
+			}
+			this->m_capacity = capacity;
+			if (capacity > 0)
+			{
+				this->m_items.reserve(capacity);
 			}
+			return true;
+		}
+
+		size_t GetRetention()
+		{
+			return this->m_capacity;
+		}
+
+		uint64_t GetDroppedCount()
+		{
+			return this->m_dropped.load(std::memory_order_relaxed);
 		}
 
-		const vector<ItsLogItem> &GetItems()
+		//
+		// Method: GetItems
+		//
+		// (i): Copy of the items in chronological order, taken under the lock
+		//      since the writer keeps appending (and overwrites in ring mode).
+		//
+		vector<ItsLogItem> GetItems()
 		{
+			this->Flush();
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			this->Linearize();
 			return this->m_items;
 		}
 
+		//
+		// Method: ForEachItem
+		//
+		// (i): Calls func for each item in chronological order without copying.
+		//      The lock is held during the calls, so func must not log.
+		//
+		template<typename Func>
+		void ForEachItem(Func&& func)
+		{
+			this->Flush();
+			std::lock_guard<std::mutex> lock(this->m_lock);
+			this->Linearize();
+			for (const auto& item : this->m_items)
+			{
+				func(item);
+			}
+		}
+
 		size_t Count()
 		{
+			this->Flush();
+			std::lock_guard<std::mutex> lock(this->m_lock);
 			return this->m_items.size();
 		}
 
 		void Clear()
 		{
+			std::lock_guard<std::mutex> lock(this->m_lock);
 			this->m_items.clear();
+			this->m_head = 0;
 		}
 
 		string ToString()
 		{
+			this->Flush();
+			std::lock_guard<std::mutex> lock(this->m_lock);
+
 			stringstream ss;
-			for (auto i : this->m_items)
+			for (size_t i = 0; i < this->m_items.size(); i++)
 			{
-				ss << i.ToString() << endl;
+				ss << this->ItemAt(i).ToString() << endl;
 			}
 
 			string retVal = ss.str();
@@ -1500,21 +6991,15 @@ namespace ItSoftware::Linux
 
 		string ToString(uint32_t tailN)
 		{
-			stringstream ss;
-			if ( this->m_items.size() > tailN ) {
-				auto ptr = this->m_items.end();
-				ptr -= tailN;
+			this->Flush();
+			std::lock_guard<std::mutex> lock(this->m_lock);
 
-				do
-				{
-					ss << (*ptr).ToString() << endl;
-				} while (++ptr != this->m_items.end());
-			}
-			else {
-				for (auto i : this->m_items)
-				{
-					ss << i.ToString() << endl;
-				}
+			stringstream ss;
+			size_t count = this->m_items.size();
+			size_t i = (count > tailN) ? count - tailN : 0;
+			for (; i < count; i++)
+			{
+				ss << this->ItemAt(i).ToString() << endl;
 			}
 
 			string retVal = ss.str();
@@ -1541,58 +7026,189 @@ namespace ItSoftware::Linux
 	//
 	struct ItsID
 	{
+	private:
+		static constexpr const char* DataMin{ "abcdefghijklmnopqrstuvwxyz" };
+		static constexpr const char* DataMaj{ "ABCDEFGHIJKLMNOPQRSTUVWXYZ" };
+		static constexpr const char* DataMinMaj{ "aAbBcCdDeEfFgGhHiIjJkKlLmMnNoOpPqQrRsStTuUvVwWxXyYzZ" };
+		static constexpr const char* DataMinNum{ "abcdefghijklmnopqrstuvwxyz0123456789" };
+		static constexpr const char* DataMajNum{ "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789" };
+		static constexpr const char* DataMinMajNum{ "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789" };
+
+		// (i): A repeated character would be drawn more often than the others.
+		static constexpr bool IsUnique(std::string_view alphabet)
+		{
+			for (size_t i = 0; i < alphabet.size(); i++) {
+				for (size_t j = i + 1; j < alphabet.size(); j++) {
+					if (alphabet[i] == alphabet[j]) {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
 	public:
-		static string CreateID(size_t count, ItsCreateIDOptions options, bool includeNumbers)
+		static constexpr size_t DefaultLength = 16;
+
+		//
+		// Function: GetAlphabet
+		//
+		// (i): The distinct characters an ID is drawn from, each equally likely.
+		//
+		static constexpr std::string_view GetAlphabet(ItsCreateIDOptions options, bool includeNumbers)
 		{
-			if (count == 0)
+			static_assert(IsUnique(DataMin) && IsUnique(DataMaj) && IsUnique(DataMinMaj), "ItsID alphabet has duplicates");
+			static_assert(IsUnique(DataMinNum) && IsUnique(DataMajNum) && IsUnique(DataMinMajNum), "ItsID alphabet has duplicates");
+			switch (options)
 			{
-				count = 16;
+			case ItsCreateIDOptions::LowerAndUpperCase:
+				return includeNumbers ? DataMinMajNum : DataMinMaj;
+			case ItsCreateIDOptions::UpperCase:
+				return includeNumbers ? DataMajNum : DataMaj;
+			default:
+				return includeNumbers ? DataMinNum : DataMin;
 			}
+		}
 
-			string dataMin = "abcdefghijklmnopqrstuvwxyz";
-			string dataMaj = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-			string dataMinMaj = "aAbBcCdDeEfFgGhHiIjJkKlLmMnNoOpPqQrRsStTuUvVwWxXyYzZ";
-			string dataMinNum = "a0b1c2d3e4f5g6h7i8j9k0l1m2n3o4p5q6r7s8t9u0v1w2x3y4z5";
-			string dataMajNum = "A0B1C2D3E4F5G6G7I8J9K0L1M2N3O4P5Q6R7S8T9U0V1W2X3Y4Z5";
-			string dataMinMajNum = "aA0bB1cC2dD3eE4fF5gG6hH7iI8jJ9kK0lL1mM2nN3oO4pP5qQ6rR7sS8tT9uU0vV1wW2xX3yY4zZ5";
+		//
+		// Function: Fill
+		//
+		// (i): Writes count characters from alphabet to out, not zero terminated. Each
+		//      64 bit word from gen gives four 16 bit fields mapped by Lemire's
+		//      multiply-shift; the few fields that would bias the result are rejected
+		//      (under 0.2% for these alphabets, so the branch is predictable).
+		//
+		template <typename Generator>
+		static void Fill(Generator& gen, std::string_view alphabet, char* out, size_t count)
+		{
+			const uint32_t n = static_cast<uint32_t>(alphabet.size());
+			const uint32_t threshold = 65536u % n;
+			size_t i = 0;
+			while (i < count) {
+				uint64_t word = ItsRandomBits::Next64(gen);
+				for (int field = 0; field < 4 && i < count; field++, word >>= 16) {
+					uint32_t m = static_cast<uint32_t>(word & 0xFFFF) * n;
+					if ((m & 0xFFFF) >= threshold) {
+						out[i++] = alphabet[m >> 16];
+					}
+				}
+			}
+		}
 
-			string data = dataMin;
-			if (options == ItsCreateIDOptions::LowerAndUpperCase && includeNumbers)
-			{
-				data = dataMinMajNum;
+		//
+		// Function: CreateID
+		//
+		// (i): Allocation free CreateID, writes count characters (16 for 0) and a
+		//      terminating zero into buffer. Returns the length, or 0 if buffer is too small.
+		//
+		template <typename Generator>
+		static size_t CreateID(Generator& gen, char* buffer, size_t size, size_t count, ItsCreateIDOptions options, bool includeNumbers)
+		{
+			if (count == 0) {
+				count = ItsID::DefaultLength;
 			}
-			if (options == ItsCreateIDOptions::LowerAndUpperCase && !includeNumbers)
-			{
-				data = dataMinMaj;
+			if (buffer == nullptr || size < count + 1) {
+				return 0;
 			}
-			else if (options == ItsCreateIDOptions::LowerCase && includeNumbers)
-			{
-				data = dataMinNum;
+			ItsID::Fill(gen, ItsID::GetAlphabet(options, includeNumbers), buffer, count);
+			buffer[count] = '\0';
+			return count;
+		}
+
+		static size_t CreateID(char* buffer, size_t size, size_t count, ItsCreateIDOptions options, bool includeNumbers)
+		{
+			return ItsID::CreateID(ItsRandomEngine(), buffer, size, count, options, includeNumbers);
+		}
+
+		static string CreateID(size_t count, ItsCreateIDOptions options, bool includeNumbers)
+		{
+			if (count == 0) {
+				count = ItsID::DefaultLength;
 			}
-			else if (options == ItsCreateIDOptions::LowerCase && !includeNumbers)
-			{
-				data = dataMin;
+			string id(count, '\0');
+			ItsID::Fill(ItsRandomEngine(), ItsID::GetAlphabet(options, includeNumbers), id.data(), count);
+			return id;
+		}
+
+		//
+		// Function: CreateIDs
+		//
+		// (i): Bulk CreateID into one arena: number IDs of count characters (16 for 0),
+		//      each zero terminated, ID i starting at arena + i * (count + 1). Returns the
+		//      bytes written, or 0 if arena is too small.
+		//
+		template <typename Generator>
+		static size_t CreateIDs(Generator& gen, char* arena, size_t size, size_t number, size_t count, ItsCreateIDOptions options, bool includeNumbers)
+		{
+			if (count == 0) {
+				count = ItsID::DefaultLength;
 			}
-			else if (options == ItsCreateIDOptions::UpperCase && includeNumbers)
-			{
-				data = dataMajNum;
+			size_t stride = count + 1;
+			if (arena == nullptr || number > size / stride) {
+				return 0;
 			}
-			else if (options == ItsCreateIDOptions::UpperCase && !includeNumbers)
-			{
-				data = dataMaj;
+			std::string_view alphabet = ItsID::GetAlphabet(options, includeNumbers);
+			for (size_t i = 0; i < number; i++) {
+				char* id = arena + i * stride;
+				ItsID::Fill(gen, alphabet, id, count);
+				id[count] = '\0';
 			}
+			return number * stride;
+		}
 
-			stringstream id;
-			int i = 0;
-			do
-			{
-				size_t j = ItsRandom<size_t>(0, data.size() - 1);
-				id << data[j];
+		static size_t CreateIDs(char* arena, size_t size, size_t number, size_t count, ItsCreateIDOptions options, bool includeNumbers)
+		{
+			return ItsID::CreateIDs(ItsRandomEngine(), arena, size, number, count, options, includeNumbers);
+		}
 
-			} while (++i < count);
-			
-			string retVal = id.str();
-			return retVal;
+		//
+		// Function: CreateSecureID
+		//
+		// (i): CreateID drawing from the thread's ItsChaCha20Random, for session tokens
+		//      and other IDs that must not be predictable.
+		//
+		static string CreateSecureID(size_t count, ItsCreateIDOptions options, bool includeNumbers)
+		{
+			if (count == 0) {
+				count = ItsID::DefaultLength;
+			}
+			string id(count, '\0');
+			ItsID::Fill(ItsChaCha20Random::ThreadLocal(), ItsID::GetAlphabet(options, includeNumbers), id.data(), count);
+			return id;
+		}
+
+		static size_t CreateSecureID(char* buffer, size_t size, size_t count, ItsCreateIDOptions options, bool includeNumbers)
+		{
+			return ItsID::CreateID(ItsChaCha20Random::ThreadLocal(), buffer, size, count, options, includeNumbers);
+		}
+
+		static size_t CreateSecureIDs(char* arena, size_t size, size_t number, size_t count, ItsCreateIDOptions options, bool includeNumbers)
+		{
+			return ItsID::CreateIDs(ItsChaCha20Random::ThreadLocal(), arena, size, number, count, options, includeNumbers);
+		}
+
+		//
+		// Function: CreateIDs
+		//
+		// (i): Bulk CreateID returning the arena as one string, layout as above, read
+		//      ID i with GetID.
+		//
+		static string CreateIDs(size_t number, size_t count, ItsCreateIDOptions options, bool includeNumbers)
+		{
+			if (count == 0) {
+				count = ItsID::DefaultLength;
+			}
+			string arena(number * (count + 1), '\0');
+			ItsID::CreateIDs(arena.data(), arena.size(), number, count, options, includeNumbers);
+			return arena;
+		}
+
+		static std::string_view GetID(std::string_view arena, size_t count, size_t index)
+		{
+			if (count == 0) {
+				count = ItsID::DefaultLength;
+			}
+			return arena.substr(index * (count + 1), count);
 		}
 	};
 } // namespace ItSoftware::Linux
\ No newline at end of file